@@ -0,0 +1,162 @@
+
+#include "Cases.hh"
+#include "Board.hh"
+#include "CandidateSolver.hh"
+#include "Corpus.hh"
+#include "PackedBoard.hh"
+#include "SudokuMatrix.hh"
+#include <core_utils/RNG.hh>
+#include <cstdio>
+#include <filesystem>
+
+namespace sudoku::bench {
+namespace {
+
+/// @brief - The number of samples of the benchmarks of the board
+/// for each pass.
+constexpr unsigned boardSamples = 1000u;
+
+/// @brief - The number of samples of the benchmarks of the saves
+/// for each pass.
+constexpr unsigned saveSamples = 200u;
+
+void runBoard(Runner &runner, const Options &options) {
+  Board board;
+  fill(board, corpora().front().puzzles.front());
+
+  unsigned empty = 0u;
+  for (unsigned y = 0u; y < board.h(); ++y) {
+    for (unsigned x = 0u; x < board.w(); ++x) {
+      empty += (board.empty(x, y) ? 1u : 0u);
+    }
+  }
+
+  // Each sample checks all digits in all cells.
+  runner.run("board/canFit", "calls", boardSamples * options.repeat,
+             board.w() * board.h() * counting::candidates,
+             [&board](unsigned /*id*/) {
+               unsigned fit = 0u;
+               for (unsigned y = 0u; y < board.h(); ++y) {
+                 for (unsigned x = 0u; x < board.w(); ++x) {
+                   for (unsigned d = 1u; d <= counting::candidates; ++d) {
+                     fit += (board.canFit(x, y, d) ? 1u : 0u);
+                   }
+                 }
+               }
+
+               return fit > 0u;
+             });
+
+  // Each sample puts a digit in all empty cells and clears them.
+  runner.run("board/put", "calls", boardSamples * options.repeat, 2u * empty,
+             [&board](unsigned id) {
+               unsigned digit = 1u + id % counting::candidates;
+               for (unsigned y = 0u; y < board.h(); ++y) {
+                 for (unsigned x = 0u; x < board.w(); ++x) {
+                   if (board.empty(x, y)) {
+                     board.put(x, y, digit, DigitKind::UserGenerated);
+                     board.put(x, y, 0u, DigitKind::None);
+                   }
+                 }
+               }
+
+               return true;
+             });
+}
+
+void runSaves(Runner &runner, const Options &options) {
+  Board board;
+  fill(board, corpora().front().puzzles.front());
+
+  SaveMetadata metadata = board.pack().metadata(Level::Easy, 0);
+  std::string file = (std::filesystem::temp_directory_path() / "sudoku-bench.sav").string();
+
+  runner.run("board/save", "saves", saveSamples * options.repeat, 1u,
+             [&board, &metadata, &file](unsigned /*id*/) {
+               board.save(file, metadata);
+               return true;
+             });
+
+  runner.run("board/load", "loads", saveSamples * options.repeat, 1u,
+             [&board, &file](unsigned /*id*/) {
+               board.load(file);
+               return !board.empty(0u, 0u);
+             });
+
+  std::remove(file.c_str());
+}
+
+void runSolvers(Runner &runner, const Options &options) {
+  for (const Corpus &corpus : corpora()) {
+    const std::vector<algorithm::Grid> &puzzles = corpus.puzzles;
+    unsigned count = puzzles.size() * options.repeat;
+
+    runner.run("solver/candidate/" + corpus.name, "puzzles", count, 1u,
+               [&puzzles](unsigned id) {
+                 algorithm::CandidateSolver solver;
+                 solver.load(puzzles[id % puzzles.size()]);
+                 return solver.solve() > 0u;
+               });
+
+    // Measures the overhead of recording the steps of the search
+    // to replay them.
+    runner.run("solver/candidate-record/" + corpus.name, "puzzles", count, 1u,
+               [&puzzles](unsigned id) {
+                 algorithm::StepLog log;
+                 algorithm::CandidateSolver solver;
+                 solver.record(&log);
+                 solver.load(puzzles[id % puzzles.size()]);
+                 return solver.solve() > 0u && log.size() > 0u;
+               });
+
+    runner.run("solver/candidate-unique/" + corpus.name, "puzzles", count, 1u,
+               [&puzzles](unsigned id) {
+                 algorithm::CandidateSolver solver;
+                 solver.load(puzzles[id % puzzles.size()]);
+                 return solver.status() == algorithm::Status::Unique;
+               });
+
+    // The board is prepared outside of the measured function so
+    // that only the solver is timed.
+    std::vector<Board> boards(puzzles.size());
+    for (unsigned id = 0u; id < puzzles.size(); ++id) {
+      fill(boards[id], puzzles[id]);
+    }
+
+    runner.run("solver/dlx/" + corpus.name, "puzzles", count, 1u,
+               [&boards](unsigned id) {
+                 algorithm::SudokuMatrix solver;
+                 return !solver.solve(boards[id % boards.size()]).empty();
+               });
+  }
+}
+
+void runGenerator(Runner &runner, const Options &options) {
+  const std::pair<std::string, Level> levels[] = {
+      {"easy", Level::Easy}, {"medium", Level::Medium}, {"hard", Level::Hard}};
+
+  for (const auto &level : levels) {
+    unsigned digits = toClues(level.second);
+    unsigned seed = options.seed;
+
+    // Generating a board is slow: each seed is only used once.
+    runner.run("generator/" + level.first, "boards", options.count, 1u,
+               [digits, seed](unsigned id) {
+                 utils::RNG rng(static_cast<int>(seed + id));
+
+                 Board board;
+                 return board.generate(digits, rng);
+               });
+  }
+}
+
+} // namespace
+
+void runAll(Runner &runner, const Options &options) {
+  runBoard(runner, options);
+  runSaves(runner, options);
+  runSolvers(runner, options);
+  runGenerator(runner, options);
+}
+
+} // namespace sudoku::bench
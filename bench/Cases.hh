@@ -0,0 +1,53 @@
+#ifndef CASES_HH
+#define CASES_HH
+
+#include "Runner.hh"
+
+namespace sudoku::bench {
+
+/// @brief - The options controlling the benchmarks.
+struct Options {
+  // The file to write the JSON results to (empty to skip it).
+  std::string output{};
+
+  // The text which should appear in the name of the benchmarks
+  // to run (empty to run all of them).
+  std::string filter{};
+
+  // The number of passes over the corpora.
+  unsigned repeat{3u};
+
+  // The first seed used to generate boards.
+  unsigned seed{1u};
+
+  // The number of boards generated for each level.
+  unsigned count{5u};
+
+  // The baseline file to write the costs of the regression
+  // workloads to (empty to skip it).
+  std::string record{};
+
+  // The baseline file to compare the costs of the regression
+  // workloads with (empty to skip it).
+  std::string check{};
+
+  // The tolerated increase of the costs in percent.
+  unsigned tolerance{5u};
+
+  // The tolerated increase of the CPU time in percent, compared
+  // when the instructions can't be.
+  unsigned cpuTolerance{50u};
+};
+
+/**
+ * @brief - Run all the benchmarks: the operations of the board,
+ *          the saving and loading of games, each solver on each
+ *          corpus and the generator for each level.
+ * @param runner - the runner measuring the benchmarks.
+ * @param options - the options of the benchmarks.
+ */
+void runAll(Runner &runner, const Options &options);
+
+} // namespace sudoku::bench
+
+#endif /* CASES_HH */
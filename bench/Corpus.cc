@@ -0,0 +1,82 @@
+
+#include "Corpus.hh"
+
+namespace sudoku::bench {
+namespace {
+
+// All the puzzles below have a unique solution.
+const char *const easyPuzzles[] = {
+    "530070000600195000098000060800060003400803001700020006060000280000419005000080079",
+    "003020600900305001001806400008102900700000008006708200002609500800203009005010300",
+    "020810740700003100090002805009040087400208003160030200302700060005600008076051090",
+    "030000064700609000050020008000800243240003000860040007500038410000205000329400605",
+    "001008009009342510000010070804070195007000003600401020070000000080104050012980060",
+    "200051000000000490681000005100000004007020586060030107000240309305008040400307608",
+};
+
+const char *const hardPuzzles[] = {
+    // AI Escargot.
+    "100007090030020008009600500005300900010080002600004000300000010040000007007000300",
+    // Arto Inkala (2010).
+    "800000000003600000070090200050007000000045700000100030001000068008500010090000400",
+    // Easter Monster.
+    "100000002090400050006000700050903000000070000000850040700000600030009080002000001",
+    "001004000000060305000900000800000703000000028500070600300080006009200000040001000",
+    "480300000000000071020000000705000060000200800000000000001076000300000400000050000",
+    "000000907000420180000705026100904000050000040000507009920108000034059000507000000",
+    "100920000524010000000000070050008102000000000402700090060000000000030945000071006",
+};
+
+const char *const seventeenClues[] = {
+    "400000805030000000000700000020000060000080400000010000000603070500200000104000000",
+    "520006000000000701300000000000400800600000050000000000041800000000030020008700000",
+    "600000803040700000000000000000504070300200000106000000020000050000080600000010000",
+    "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+    "000000010400000000020000000000050604008000300001090000300400200050100000000807000",
+    "000000012003600000000007000410020000000500300700000600280000040000300500000000000",
+    "000000013000700060000508000000400800106000000000000200740000050020000400000010000",
+    "000000013020500000000000000103000070000802000004000000000340500670000200000010000",
+};
+
+template <std::size_t N>
+Corpus parse(const std::string &name, const char *const (&puzzles)[N]) {
+  Corpus out{name, {}};
+
+  for (const char *puzzle : puzzles) {
+    algorithm::Grid grid;
+    for (unsigned cell = 0u; cell < counting::cellsCount; ++cell) {
+      grid[cell] = static_cast<std::uint8_t>(puzzle[cell] - '0');
+    }
+
+    out.puzzles.push_back(grid);
+  }
+
+  return out;
+}
+
+} // namespace
+
+const std::vector<Corpus> &corpora() {
+  static const std::vector<Corpus> corpora = {
+      parse("easy", easyPuzzles),
+      parse("hard", hardPuzzles),
+      parse("17-clues", seventeenClues),
+  };
+
+  return corpora;
+}
+
+void fill(Board &board, const algorithm::Grid &grid) {
+  board.reset();
+
+  for (unsigned y = 0u; y < board.h(); ++y) {
+    for (unsigned x = 0u; x < board.w(); ++x) {
+      unsigned digit = grid[y * board.w() + x];
+      if (digit != 0u) {
+        board.put(x, y, digit, DigitKind::Generated);
+      }
+    }
+  }
+}
+
+} // namespace sudoku::bench
@@ -0,0 +1,39 @@
+#ifndef CORPUS_HH
+#define CORPUS_HH
+
+#include "CandidateSolver.hh"
+#include <string>
+#include <vector>
+
+namespace sudoku::bench {
+
+/// @brief - A named set of puzzles embedded in the benchmark so that
+/// runs on different machines or revisions use the same inputs.
+struct Corpus {
+  // The name of the corpus.
+  std::string name;
+
+  // The puzzles of the corpus.
+  std::vector<algorithm::Grid> puzzles;
+};
+
+/**
+ * @brief - The corpora used by the benchmark: easy puzzles solved
+ *          without guessing, hard puzzles known to defeat human
+ *          techniques and puzzles with only 17 clues (the minimum
+ *          for a puzzle with a unique solution).
+ * @return - the list of corpora.
+ */
+const std::vector<Corpus> &corpora();
+
+/**
+ * @brief - Replace the content of the board with the digits of the
+ *          input puzzle, marked as generated.
+ * @param board - the board to fill.
+ * @param grid - the puzzle to put on the board.
+ */
+void fill(Board &board, const algorithm::Grid &grid);
+
+} // namespace sudoku::bench
+
+#endif /* CORPUS_HH */
@@ -0,0 +1,57 @@
+
+#include "InstructionCounter.hh"
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace sudoku::bench {
+
+InstructionCounter::InstructionCounter() noexcept : m_fd(-1) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+InstructionCounter::~InstructionCounter() {
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+}
+
+bool InstructionCounter::available() const noexcept { return m_fd >= 0; }
+
+void InstructionCounter::start() noexcept {
+  if (m_fd < 0) {
+    return;
+  }
+
+  ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+std::uint64_t InstructionCounter::stop() noexcept {
+  if (m_fd < 0) {
+    return 0u;
+  }
+
+  ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+
+  std::uint64_t count = 0u;
+  if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+    return 0u;
+  }
+
+  return count;
+}
+
+} // namespace sudoku::bench
@@ -0,0 +1,57 @@
+#ifndef INSTRUCTION_COUNTER_HH
+#define INSTRUCTION_COUNTER_HH
+
+#include <cstdint>
+
+namespace sudoku::bench {
+
+/// @brief - Counts the instructions retired by the calling thread
+/// in user space using the hardware counters exposed through
+/// `perf_event_open`. Unlike durations, instruction counts barely
+/// change between runs of the same workload. The counters are not
+/// available everywhere (virtual machines, restrictive values of
+/// `kernel.perf_event_paranoid`): `available` should be checked.
+class InstructionCounter {
+public:
+  /**
+   * @brief - Open the counter for the calling thread.
+   */
+  InstructionCounter() noexcept;
+
+  /**
+   * @brief - Release the counter.
+   */
+  ~InstructionCounter();
+
+  InstructionCounter(const InstructionCounter &) = delete;
+  InstructionCounter &operator=(const InstructionCounter &) = delete;
+
+  /**
+   * @brief - Whether the counter could be opened.
+   * @return - `true` if instructions can be counted.
+   */
+  bool available() const noexcept;
+
+  /**
+   * @brief - Reset the counter and start counting.
+   */
+  void start() noexcept;
+
+  /**
+   * @brief - Stop counting.
+   * @return - the number of instructions since the last call to
+   *           `start` or zero if the counter is not available.
+   */
+  std::uint64_t stop() noexcept;
+
+private:
+  /**
+   * @brief - The file descriptor of the counter (negative if it is
+   *          not available).
+   */
+  int m_fd;
+};
+
+} // namespace sudoku::bench
+
+#endif /* INSTRUCTION_COUNTER_HH */
@@ -0,0 +1,300 @@
+
+#include "Regression.hh"
+#include "Allocations.hh"
+#include "Board.hh"
+#include "CandidateSolver.hh"
+#include "Corpus.hh"
+#include "InstructionCounter.hh"
+#include "PackedBoard.hh"
+#include "SudokuMatrix.hh"
+#include <core_utils/RNG.hh>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+namespace sudoku::bench {
+namespace {
+
+/// @brief - The number of times the board operations are repeated.
+constexpr unsigned boardPasses = 100u;
+
+/// @brief - The number of games saved and loaded.
+constexpr unsigned savePasses = 50u;
+
+/// @brief - The number of runs of each workload whose CPU time is
+/// measured, including the one counting the instructions.
+constexpr unsigned cpuRuns = 3u;
+
+/// @brief - The increase of the CPU time of a workload, in
+/// microseconds, which is always tolerated: short workloads are
+/// dominated by the scheduling noise.
+constexpr std::uint64_t cpuSlack = 10000u;
+
+/// @brief - The CPU time consumed by the process, in nanoseconds,
+/// or a negative value if it is not available.
+std::int64_t cpuTime() noexcept {
+  timespec ts;
+  if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+    return -1;
+  }
+
+  return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void execute(const std::function<void()> &workload) noexcept {
+  try {
+    workload();
+  } catch (const std::exception & /*e*/) {
+    // Failures are part of the workload: what matters is that the
+    // same work is done for each run.
+  }
+}
+
+Cost measure(InstructionCounter &counter, const std::string &name,
+             const std::function<void()> &workload) {
+  Cost out;
+  out.name = name;
+  out.counted = counter.available();
+
+  // Run the workload once so that one-time initializations (such as
+  // the registration of metrics) are not measured.
+  execute(workload);
+
+  allocations::Counts before = allocations::total();
+  std::int64_t start = cpuTime();
+  counter.start();
+
+  execute(workload);
+
+  out.instructions = counter.stop();
+  std::int64_t end = cpuTime();
+  out.allocations = allocations::total().count - before.count;
+
+  // The CPU time is noisy: keep the shortest of a few runs.
+  std::int64_t best = end - start;
+  for (unsigned run = 1u; run < cpuRuns && start >= 0 && end >= 0; ++run) {
+    start = cpuTime();
+    execute(workload);
+    end = cpuTime();
+
+    best = std::min(best, end - start);
+  }
+
+  out.timed = (start >= 0 && end >= 0);
+  out.cpuTime = static_cast<std::uint64_t>(std::max<std::int64_t>(best, 0) /
+                                           1000);
+
+  return out;
+}
+
+void boardWorkload() {
+  Board board;
+  fill(board, corpora().front().puzzles.front());
+
+  unsigned fit = 0u;
+  for (unsigned pass = 0u; pass < boardPasses; ++pass) {
+    for (unsigned y = 0u; y < board.h(); ++y) {
+      for (unsigned x = 0u; x < board.w(); ++x) {
+        for (unsigned d = 1u; d <= counting::candidates; ++d) {
+          fit += (board.canFit(x, y, d) ? 1u : 0u);
+        }
+
+        if (board.empty(x, y)) {
+          board.put(x, y, 1u + pass % counting::candidates,
+                    DigitKind::UserGenerated);
+          board.put(x, y, 0u, DigitKind::None);
+        }
+      }
+    }
+  }
+}
+
+void savesWorkload() {
+  Board board;
+  fill(board, corpora().front().puzzles.front());
+
+  SaveMetadata metadata = board.pack().metadata(Level::Easy, 0);
+  std::string file =
+      (std::filesystem::temp_directory_path() / "sudoku-regression.sav")
+          .string();
+
+  for (unsigned pass = 0u; pass < savePasses; ++pass) {
+    board.save(file, metadata);
+    board.load(file);
+  }
+
+  std::remove(file.c_str());
+}
+
+void candidateWorkload() {
+  algorithm::CandidateSolver solver;
+
+  for (const Corpus &corpus : corpora()) {
+    for (const algorithm::Grid &puzzle : corpus.puzzles) {
+      solver.load(puzzle);
+      solver.status();
+    }
+  }
+}
+
+void dlxWorkload() {
+  for (const algorithm::Grid &puzzle : corpora().front().puzzles) {
+    Board board;
+    fill(board, puzzle);
+
+    algorithm::SudokuMatrix solver;
+    solver.solve(board);
+  }
+}
+
+void generatorWorkload(unsigned seed) {
+  utils::RNG rng(static_cast<int>(seed));
+
+  Board board;
+  board.generate(toClues(Level::Medium), rng);
+}
+
+/// @brief - Parse a cost of the baseline which might be missing
+/// (written as '-').
+bool parseCount(const std::string &str, bool &known, std::uint64_t &out) {
+  known = (str != "-");
+  if (!known) {
+    return true;
+  }
+
+  if (str.empty() || str.size() > 19u ||
+      str.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+
+  out = std::stoull(str);
+  return true;
+}
+
+} // namespace
+
+std::vector<Cost> measureWorkloads(unsigned seed) {
+  InstructionCounter counter;
+  std::vector<Cost> out;
+
+  out.push_back(measure(counter, "board/canFit-put", boardWorkload));
+  out.push_back(measure(counter, "board/save-load", savesWorkload));
+  out.push_back(measure(counter, "solver/candidate", candidateWorkload));
+  out.push_back(measure(counter, "solver/dlx", dlxWorkload));
+  out.push_back(measure(counter, "generator/medium",
+                        [seed]() { generatorWorkload(seed); }));
+
+  return out;
+}
+
+void writeBaseline(std::ostream &out, const std::vector<Cost> &costs) {
+  out << "# Baseline of the regression check of sudoku-bench: one line\n"
+      << "# per workload with its name, the number of instructions ('-'\n"
+      << "# when they could not be counted), the number of allocations\n"
+      << "# and the CPU time in microseconds ('-' when not measured).\n";
+
+  for (const Cost &cost : costs) {
+    out << cost.name << " "
+        << (cost.counted ? std::to_string(cost.instructions) : "-") << " "
+        << cost.allocations << " "
+        << (cost.timed ? std::to_string(cost.cpuTime) : "-") << '\n';
+  }
+}
+
+bool readBaseline(std::istream &in, std::vector<Cost> &costs) {
+  costs.clear();
+
+  std::string line;
+  while (std::getline(in, line)) {
+    std::size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#') {
+      continue;
+    }
+
+    std::istringstream fields(line);
+    Cost cost;
+    std::string instructions;
+
+    if (!(fields >> cost.name >> instructions >> cost.allocations)) {
+      return false;
+    }
+
+    if (!parseCount(instructions, cost.counted, cost.instructions)) {
+      return false;
+    }
+
+    // The CPU time is optional: older baselines don't have it.
+    std::string cpu;
+    if (fields >> cpu && !parseCount(cpu, cost.timed, cost.cpuTime)) {
+      return false;
+    }
+
+    costs.push_back(cost);
+  }
+
+  return true;
+}
+
+bool compare(const std::vector<Cost> &costs, const std::vector<Cost> &baseline,
+             double tolerance, double cpuTolerance, std::ostream &out) {
+  bool success = true;
+
+  auto check = [&out](const std::string &metric, std::uint64_t current,
+                      std::uint64_t reference, double tolerance,
+                      std::uint64_t slack = 0u) {
+    double change =
+        (reference > 0u ? 100.0 * (static_cast<double>(current) - reference) /
+                              reference
+                        : (current > 0u ? 100.0 : 0.0));
+    bool ok = (change <= tolerance || current <= reference + slack);
+
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%+.2f%%", change);
+
+    out << "  " << metric << ": " << current << " (baseline " << reference
+        << ", " << buf << ")" << (ok ? "" : " REGRESSION") << '\n';
+
+    return ok;
+  };
+
+  for (const Cost &cost : costs) {
+    const Cost *ref = nullptr;
+    for (const Cost &b : baseline) {
+      if (b.name == cost.name) {
+        ref = &b;
+      }
+    }
+
+    out << cost.name << '\n';
+    if (ref == nullptr) {
+      out << "  no baseline\n";
+      continue;
+    }
+
+    if (cost.counted && ref->counted) {
+      success = check("instructions", cost.instructions, ref->instructions,
+                      tolerance) &&
+                success;
+    } else if (cost.timed && ref->timed) {
+      success = check("cpu time (us)", cost.cpuTime, ref->cpuTime,
+                      cpuTolerance, cpuSlack) &&
+                success;
+    } else {
+      out << "  instructions: not compared\n";
+    }
+
+    success = check("allocations", cost.allocations, ref->allocations,
+                    tolerance) &&
+              success;
+  }
+
+  return success;
+}
+
+} // namespace sudoku::bench
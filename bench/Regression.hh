@@ -0,0 +1,82 @@
+#ifndef REGRESSION_HH
+#define REGRESSION_HH
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace sudoku::bench {
+
+/// @brief - The cost of a deterministic workload. The instructions
+/// and the allocations do not depend on the load of the machine so
+/// they can be compared with a baseline recorded earlier. The CPU
+/// time is only a fallback for machines which can't count the
+/// instructions and is compared with a wider tolerance.
+struct Cost {
+  // The name of the workload.
+  std::string name;
+
+  // Whether the instructions could be counted.
+  bool counted{false};
+
+  // The number of instructions executed in user space.
+  std::uint64_t instructions{0u};
+
+  // The number of dynamic allocations.
+  std::uint64_t allocations{0u};
+
+  // Whether the CPU time could be measured.
+  bool timed{false};
+
+  // The shortest CPU time of the workload over a few runs, in
+  // microseconds.
+  std::uint64_t cpuTime{0u};
+};
+
+/**
+ * @brief - Run the workloads of the regression check: a short and
+ *          deterministic mix of solving, generating, saving and
+ *          loading.
+ * @param seed - the seed used to generate boards.
+ * @return - the cost of each workload.
+ */
+std::vector<Cost> measureWorkloads(unsigned seed);
+
+/**
+ * @brief - Write the input costs as a baseline file.
+ * @param out - the stream to write to.
+ * @param costs - the costs to save.
+ */
+void writeBaseline(std::ostream &out, const std::vector<Cost> &costs);
+
+/**
+ * @brief - Read the costs saved in a baseline file. Empty lines and
+ *          lines starting with `#` are ignored.
+ * @param in - the stream to read from.
+ * @param costs - output argument receiving the costs.
+ * @return - `false` if the file is malformed.
+ */
+bool readBaseline(std::istream &in, std::vector<Cost> &costs);
+
+/**
+ * @brief - Compare the costs with the baseline and report the
+ *          differences. A workload regresses when its instructions
+ *          or its allocations exceed the baseline by more than the
+ *          tolerance. Instructions are only compared when they are
+ *          known for both: otherwise the CPU time is compared with
+ *          its own tolerance if it is known for both.
+ * @param costs - the costs of the current revision.
+ * @param baseline - the costs of the baseline.
+ * @param tolerance - the tolerated increase in percent.
+ * @param cpuTolerance - the tolerated increase of the CPU time in
+ *                       percent.
+ * @param out - the stream receiving the report.
+ * @return - `true` if no workload regressed.
+ */
+bool compare(const std::vector<Cost> &costs, const std::vector<Cost> &baseline,
+             double tolerance, double cpuTolerance, std::ostream &out);
+
+} // namespace sudoku::bench
+
+#endif /* REGRESSION_HH */
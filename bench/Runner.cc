@@ -0,0 +1,194 @@
+
+#include "Runner.hh"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <ostream>
+
+namespace sudoku::bench {
+namespace {
+
+double percentile(const std::vector<double> &sorted, double ratio) noexcept {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+
+  std::size_t id = static_cast<std::size_t>(ratio * (sorted.size() - 1u));
+  return sorted[id];
+}
+
+bool execute(const Runner::Sample &sample, unsigned id) noexcept {
+  try {
+    return sample(id);
+  } catch (const std::exception & /*e*/) {
+    return false;
+  }
+}
+
+std::string format(double value, unsigned precision) {
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(precision), value);
+
+  return buf;
+}
+
+} // namespace
+
+Runner::Runner(const std::string &filter) : m_filter(filter), m_results() {}
+
+void Runner::run(const std::string &name, const std::string &unit,
+                 unsigned count, unsigned opsPerSample, const Sample &sample) {
+  if (count == 0u || name.find(m_filter) == std::string::npos) {
+    return;
+  }
+
+  Result res;
+  res.name = name;
+  res.unit = unit;
+  res.samples = count;
+  res.opsPerSample = opsPerSample;
+
+  std::vector<double> latencies;
+  latencies.reserve(count);
+
+  execute(sample, 0u);
+
+  std::uint64_t allocs = 0u;
+  std::uint64_t bytes = 0u;
+  std::array<std::uint64_t, allocations::categoriesCount> categories{};
+
+  for (unsigned id = 0u; id < count; ++id) {
+    std::array<std::uint64_t, allocations::categoriesCount> started;
+    for (unsigned c = 0u; c < allocations::categoriesCount; ++c) {
+      started[c] = allocations::of(static_cast<allocations::Category>(c)).count;
+    }
+    allocations::Counts before = allocations::total();
+    auto start = std::chrono::steady_clock::now();
+
+    bool success = execute(sample, id);
+
+    auto end = std::chrono::steady_clock::now();
+    allocations::Counts after = allocations::total();
+    for (unsigned c = 0u; c < allocations::categoriesCount; ++c) {
+      categories[c] +=
+          allocations::of(static_cast<allocations::Category>(c)).count -
+          started[c];
+    }
+
+    latencies.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+    allocs += after.count - before.count;
+    bytes += after.bytes - before.bytes;
+
+    if (!success) {
+      ++res.failures;
+    }
+  }
+
+  double totalUs = 0.0;
+  for (double l : latencies) {
+    totalUs += l;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+
+  res.totalMs = totalUs / 1000.0;
+  res.opsPerSecond =
+      (totalUs > 0.0 ? 1000000.0 * count * opsPerSample / totalUs : 0.0);
+  res.p50Us = percentile(latencies, 0.5);
+  res.p90Us = percentile(latencies, 0.9);
+  res.p99Us = percentile(latencies, 0.99);
+  res.maxUs = latencies.back();
+  res.allocationsPerSample = static_cast<double>(allocs) / count;
+  res.bytesPerSample = static_cast<double>(bytes) / count;
+  for (unsigned c = 0u; c < allocations::categoriesCount; ++c) {
+    res.allocationsPerCategory[c] = static_cast<double>(categories[c]) / count;
+  }
+
+  m_results.push_back(res);
+}
+
+const std::vector<Result> &Runner::results() const noexcept {
+  return m_results;
+}
+
+void Runner::print(std::ostream &out) const {
+  std::size_t width = 0u;
+  for (const Result &res : m_results) {
+    width = std::max(width, res.name.size());
+  }
+
+  for (const Result &res : m_results) {
+    out << res.name << std::string(width - res.name.size() + 2u, ' ')
+        << format(res.opsPerSecond, 1) << " " << res.unit << "/s"
+        << "  p50 " << format(res.p50Us, 2) << " us"
+        << "  p90 " << format(res.p90Us, 2) << " us"
+        << "  p99 " << format(res.p99Us, 2) << " us"
+        << "  max " << format(res.maxUs, 2) << " us"
+        << "  " << format(res.allocationsPerSample, 1) << " alloc(s)"
+        << "  " << format(res.bytesPerSample, 0) << " B";
+
+    // Detail the categories to which the allocations are attributed
+    // when they are not all performed outside of any scope.
+    if (res.allocationsPerCategory[0] < res.allocationsPerSample) {
+      const char *sep = " (";
+      for (unsigned c = 0u; c < allocations::categoriesCount; ++c) {
+        if (res.allocationsPerCategory[c] > 0.0) {
+          out << sep
+              << allocations::name(static_cast<allocations::Category>(c))
+              << " " << format(res.allocationsPerCategory[c], 1);
+          sep = ", ";
+        }
+      }
+      out << ")";
+    }
+
+    if (res.failures > 0u) {
+      out << "  " << res.failures << "/" << res.samples << " failed";
+    }
+
+    out << '\n';
+  }
+}
+
+void Runner::writeJson(std::ostream &out, unsigned seed,
+                       unsigned repeat) const {
+  out << "{\n"
+      << "  \"seed\": " << seed << ",\n"
+      << "  \"repeat\": " << repeat << ",\n"
+      << "  \"benchmarks\": [";
+
+  for (unsigned id = 0u; id < m_results.size(); ++id) {
+    const Result &res = m_results[id];
+
+    out << (id > 0u ? "," : "") << "\n    {"
+        << "\"name\": \"" << res.name << "\", "
+        << "\"unit\": \"" << res.unit << "\", "
+        << "\"samples\": " << res.samples << ", "
+        << "\"failures\": " << res.failures << ", "
+        << "\"ops_per_sample\": " << res.opsPerSample << ", "
+        << "\"total_ms\": " << format(res.totalMs, 3) << ", "
+        << "\"ops_per_second\": " << format(res.opsPerSecond, 1) << ", "
+        << "\"p50_us\": " << format(res.p50Us, 3) << ", "
+        << "\"p90_us\": " << format(res.p90Us, 3) << ", "
+        << "\"p99_us\": " << format(res.p99Us, 3) << ", "
+        << "\"max_us\": " << format(res.maxUs, 3) << ", "
+        << "\"allocations_per_sample\": "
+        << format(res.allocationsPerSample, 2) << ", "
+        << "\"bytes_per_sample\": " << format(res.bytesPerSample, 1) << ", "
+        << "\"allocations_per_category\": {";
+
+    for (unsigned c = 0u; c < allocations::categoriesCount; ++c) {
+      out << (c > 0u ? ", " : "") << "\""
+          << allocations::name(static_cast<allocations::Category>(c))
+          << "\": " << format(res.allocationsPerCategory[c], 2);
+    }
+
+    out << "}}";
+  }
+
+  out << "\n  ]\n}\n";
+}
+
+} // namespace sudoku::bench
@@ -0,0 +1,119 @@
+#ifndef RUNNER_HH
+#define RUNNER_HH
+
+#include "Allocations.hh"
+#include <array>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace sudoku::bench {
+
+/// @brief - The measurements collected when running a benchmark.
+/// Latencies are expressed in microseconds and describe a single
+/// sample (i.e. a single call to the measured function).
+struct Result {
+  // The name of the benchmark.
+  std::string name;
+
+  // The name of the operations performed by each sample.
+  std::string unit;
+
+  // The number of samples measured.
+  unsigned samples{0u};
+
+  // The number of samples which did not succeed.
+  unsigned failures{0u};
+
+  // The number of operations performed by each sample.
+  unsigned opsPerSample{1u};
+
+  // The total duration of the samples in milliseconds.
+  double totalMs{0.0};
+
+  // The number of operations performed per second.
+  double opsPerSecond{0.0};
+
+  // The percentiles of the duration of a sample.
+  double p50Us{0.0};
+  double p90Us{0.0};
+  double p99Us{0.0};
+  double maxUs{0.0};
+
+  // The average number of allocations and of bytes allocated by
+  // a sample.
+  double allocationsPerSample{0.0};
+  double bytesPerSample{0.0};
+
+  // The average number of allocations of a sample attributed to
+  // each category (see `allocations::Category`).
+  std::array<double, allocations::categoriesCount> allocationsPerCategory{};
+};
+
+/// @brief - Measures the duration and the allocations of the calls
+/// to a function and keeps the results of all the benchmarks run.
+class Runner {
+public:
+  /// @brief - A function performing the sample identified by the
+  /// input index and returning whether it succeeded. Exceptions
+  /// are counted as failures.
+  using Sample = std::function<bool(unsigned)>;
+
+  /**
+   * @brief - Create a runner for benchmarks whose name contains the
+   *          input filter.
+   * @param filter - the text which should appear in the name of the
+   *                 benchmarks to run (empty to run all of them).
+   */
+  Runner(const std::string &filter);
+
+  /**
+   * @brief - Run the input benchmark unless it is filtered out. The
+   *          first sample is executed once before the measurements
+   *          so that caches are warm.
+   * @param name - the name of the benchmark.
+   * @param unit - the name of the operations performed by a sample.
+   * @param count - the number of samples to measure.
+   * @param opsPerSample - the number of operations of each sample.
+   * @param sample - the function performing a sample.
+   */
+  void run(const std::string &name, const std::string &unit, unsigned count,
+           unsigned opsPerSample, const Sample &sample);
+
+  /**
+   * @brief - The results of the benchmarks run so far.
+   * @return - the results in the order of execution.
+   */
+  const std::vector<Result> &results() const noexcept;
+
+  /**
+   * @brief - Print a human readable summary of the results.
+   * @param out - the stream to write to.
+   */
+  void print(std::ostream &out) const;
+
+  /**
+   * @brief - Write the results as a JSON document which can be
+   *          compared with the output of other runs.
+   * @param out - the stream to write to.
+   * @param seed - the seed used by the benchmarks.
+   * @param repeat - the number of passes over the corpora.
+   */
+  void writeJson(std::ostream &out, unsigned seed, unsigned repeat) const;
+
+private:
+  /**
+   * @brief - The filter applied to the names of the benchmarks.
+   */
+  std::string m_filter;
+
+  /**
+   * @brief - The results of the benchmarks.
+   */
+  std::vector<Result> m_results;
+};
+
+} // namespace sudoku::bench
+
+#endif /* RUNNER_HH */
@@ -0,0 +1,203 @@
+
+/// @brief - Measures the performance of the sudoku engine on fixed
+/// inputs so that runs can be compared.
+
+#include "Allocations.hh"
+#include "Arguments.hh"
+#include "Cases.hh"
+#include "Regression.hh"
+#include <core_utils/log/Locator.hh>
+#include <core_utils/log/PrefixedLogger.hh>
+#include <core_utils/log/StdLogger.hh>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+/// @brief - The exit code of the regression check when the
+/// instructions can't be compared, reported as a skipped test
+/// by `ctest`.
+constexpr int skipped = 77;
+
+std::string usage() {
+  return "Usage: sudoku-bench [options]\n"
+         "\n"
+         "Options:\n"
+         "  -o, --output <file>   write the results as JSON to file\n"
+         "  -f, --filter <text>   only run benchmarks containing text\n"
+         "  -r, --repeat <n>      number of passes (default: 3)\n"
+         "  -s, --seed <n>        first seed of the generator (default: 1)\n"
+         "  -n, --count <n>       boards generated per level (default: 5)\n"
+         "      --record <file>   save the costs of the regression\n"
+         "                        workloads as a baseline\n"
+         "      --check <file>    compare the costs of the regression\n"
+         "                        workloads with a baseline (exits\n"
+         "                        with 77 when neither instructions\n"
+         "                        nor CPU time can be compared)\n"
+         "  -t, --tolerance <n>   tolerated increase in percent (default: 5)\n"
+         "      --cpu-tolerance <n>\n"
+         "                        tolerated increase of the CPU time\n"
+         "                        in percent (default: 50)\n"
+         "  -h, --help            display this message\n";
+}
+
+bool parseOptions(int argc, char **argv, sudoku::bench::Options &options,
+                  bool &help) {
+  for (int id = 1; id < argc; ++id) {
+    std::string arg = argv[id];
+
+    if (arg == "-h" || arg == "--help") {
+      help = true;
+      return true;
+    }
+
+    if (id + 1 >= argc) {
+      return false;
+    }
+
+    std::string value = argv[++id];
+    bool valid = true;
+
+    if (arg == "-o" || arg == "--output") {
+      options.output = value;
+    } else if (arg == "-f" || arg == "--filter") {
+      options.filter = value;
+    } else if (arg == "-r" || arg == "--repeat") {
+      valid = sudoku::parseUnsigned(value, options.repeat);
+    } else if (arg == "-s" || arg == "--seed") {
+      valid = sudoku::parseUnsigned(value, options.seed);
+    } else if (arg == "-n" || arg == "--count") {
+      valid = sudoku::parseUnsigned(value, options.count);
+    } else if (arg == "--record") {
+      options.record = value;
+    } else if (arg == "--check") {
+      options.check = value;
+    } else if (arg == "-t" || arg == "--tolerance") {
+      valid = sudoku::parseUnsigned(value, options.tolerance);
+    } else if (arg == "--cpu-tolerance") {
+      valid = sudoku::parseUnsigned(value, options.cpuTolerance);
+    } else {
+      valid = false;
+    }
+
+    if (!valid) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// @brief - Measure the costs of the regression workloads and save
+/// them as a baseline or compare them with one.
+int regression(const sudoku::bench::Options &options,
+               utils::log::PrefixedLogger &logger) {
+  std::vector<sudoku::bench::Cost> baseline;
+  if (!options.check.empty()) {
+    std::ifstream in(options.check);
+    if (!in.good() || !sudoku::bench::readBaseline(in, baseline)) {
+      logger.error("Failed to read baseline from \"" + options.check + "\"");
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<sudoku::bench::Cost> costs =
+      sudoku::bench::measureWorkloads(options.seed);
+
+  if (!costs.empty() && !costs.front().counted) {
+    logger.warn("Instructions can't be counted on this machine, the CPU "
+                "time is compared instead");
+  }
+
+  if (!options.record.empty()) {
+    std::ofstream out(options.record);
+    sudoku::bench::writeBaseline(out, costs);
+
+    if (!out.good()) {
+      logger.error("Failed to write baseline to \"" + options.record + "\"");
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (options.check.empty()) {
+    return EXIT_SUCCESS;
+  }
+
+  bool success = sudoku::bench::compare(costs, baseline, options.tolerance,
+                                        options.cpuTolerance, std::cout);
+  std::cout << (success ? "No regression detected" : "Regression detected")
+            << std::endl;
+
+  // Allocations alone don't catch most regressions: the check is
+  // reported as skipped rather than passed when neither the
+  // instructions nor the CPU time are known for the run and for
+  // the baseline.
+  auto known = [](const sudoku::bench::Cost &cost) {
+    return cost.counted || cost.timed;
+  };
+  auto compared = [&baseline, &known](const sudoku::bench::Cost &cost) {
+    auto ref = std::find_if(baseline.begin(), baseline.end(),
+                            [&cost](const sudoku::bench::Cost &other) {
+                              return other.name == cost.name;
+                            });
+    return ref != baseline.end() && ((cost.counted && ref->counted) ||
+                                     (cost.timed && ref->timed));
+  };
+  bool all = std::all_of(costs.begin(), costs.end(), compared) &&
+             std::all_of(baseline.begin(), baseline.end(), known);
+
+  if (success && !all) {
+    logger.warn("Neither instructions nor CPU time were compared, skipping "
+                "the check");
+    return skipped;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Create the logger: only report problems so that logging does
+  // not weigh on the measurements.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::ERROR);
+  utils::log::PrefixedLogger logger("bench", "main");
+  utils::log::Locator::provide(&raw);
+
+  sudoku::bench::Options options;
+  bool help = false;
+  if (!parseOptions(argc, argv, options, help)) {
+    std::cerr << "Invalid arguments\n\n" << usage();
+    return EXIT_FAILURE;
+  }
+  if (help) {
+    std::cout << usage();
+    return EXIT_SUCCESS;
+  }
+
+  // The benchmarks report the allocations of each sample.
+  sudoku::allocations::enable(true);
+
+  if (!options.record.empty() || !options.check.empty()) {
+    return regression(options, logger);
+  }
+
+  sudoku::bench::Runner runner(options.filter);
+  sudoku::bench::runAll(runner, options);
+
+  runner.print(std::cout);
+
+  if (!options.output.empty()) {
+    std::ofstream out(options.output);
+    runner.writeJson(out, options.seed, options.repeat);
+
+    if (!out.good()) {
+      logger.error("Failed to write results to \"" + options.output + "\"");
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,454 @@
+
+#include "Commands.hh"
+#include "Arguments.hh"
+#include "CandidateSolver.hh"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <core_utils/RNG.hh>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace sudoku::cli {
+namespace {
+
+/// @brief - A puzzle read from the input.
+struct Puzzle {
+  // Whether the line could be parsed as a puzzle.
+  bool valid;
+
+  // The digits of the puzzle.
+  algorithm::Grid grid;
+};
+
+bool parseLevel(const std::string &str, Level &out) {
+  if (str == "easy") {
+    out = Level::Easy;
+  } else if (str == "medium") {
+    out = Level::Medium;
+  } else if (str == "hard") {
+    out = Level::Hard;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+/// @brief - Parse a line of the input as a puzzle. Whitespaces
+/// are ignored so that grids can be written with separators.
+Puzzle parsePuzzle(const std::string &line) {
+  Puzzle out{true, algorithm::Grid()};
+
+  unsigned cell = 0u;
+  for (char c : line) {
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      continue;
+    }
+
+    if (cell >= counting::cellsCount) {
+      out.valid = false;
+      break;
+    }
+
+    if (c == '.' || c == '0') {
+      out.grid[cell] = 0u;
+    } else if (c >= '1' && c <= '9') {
+      out.grid[cell] = static_cast<std::uint8_t>(c - '0');
+    } else {
+      out.valid = false;
+      break;
+    }
+
+    ++cell;
+  }
+
+  out.valid = out.valid && cell == counting::cellsCount;
+
+  return out;
+}
+
+/// @brief - Read the puzzles defined in the input stream: empty
+/// lines and lines starting with a `#` are ignored.
+std::vector<Puzzle> readPuzzles(std::istream &in) {
+  std::vector<Puzzle> out;
+
+  std::string line;
+  while (std::getline(in, line)) {
+    std::size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#') {
+      continue;
+    }
+
+    out.push_back(parsePuzzle(line));
+  }
+
+  return out;
+}
+
+std::string toString(const algorithm::Grid &grid) {
+  std::string out(counting::cellsCount, '.');
+
+  for (unsigned cell = 0u; cell < counting::cellsCount; ++cell) {
+    if (grid[cell] != 0u) {
+      out[cell] = static_cast<char>('0' + grid[cell]);
+    }
+  }
+
+  return out;
+}
+
+unsigned clues(const algorithm::Grid &grid) noexcept {
+  unsigned out = 0u;
+  for (std::uint8_t digit : grid) {
+    out += (digit != 0u ? 1u : 0u);
+  }
+
+  return out;
+}
+
+unsigned threadsCount(const Options &options) noexcept {
+  if (options.threads > 0u) {
+    return options.threads;
+  }
+
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// @brief - Call the input process for each index in the range
+/// `[0; count)` using the specified number of threads. Each index
+/// is processed exactly once.
+template <typename Process>
+void parallelFor(unsigned count, unsigned threads, Process process) {
+  std::atomic<unsigned> next(0u);
+
+  auto worker = [&next, count, &process]() {
+    unsigned id;
+    while ((id = next.fetch_add(1u)) < count) {
+      process(id);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned id = 1u; id < std::min(threads, count); ++id) {
+    pool.emplace_back(worker);
+  }
+
+  worker();
+
+  for (std::thread &t : pool) {
+    t.join();
+  }
+}
+
+/// @brief - Run the input command over the streams described by
+/// the options: the command produces one line of output for each
+/// puzzle of the input.
+template <typename Command>
+int forEachPuzzle(const Options &options, Command command) {
+  std::ifstream file;
+  if (options.input != "-") {
+    file.open(options.input);
+    if (!file.good()) {
+      std::cerr << "Failed to open \"" << options.input << "\"" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<Puzzle> puzzles =
+      readPuzzles(options.input == "-" ? std::cin : file);
+  std::vector<std::string> results(puzzles.size());
+
+  parallelFor(puzzles.size(), threadsCount(options),
+              [&puzzles, &results, &command](unsigned id) {
+                if (!puzzles[id].valid) {
+                  results[id] = algorithm::toString(algorithm::Status::Invalid);
+                  return;
+                }
+
+                algorithm::CandidateSolver solver;
+                solver.load(puzzles[id].grid);
+                results[id] = command(puzzles[id], solver);
+              });
+
+  std::ofstream out;
+  if (options.output != "-") {
+    out.open(options.output);
+    if (!out.good()) {
+      std::cerr << "Failed to open \"" << options.output << "\"" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::ostream &os = (options.output == "-" ? std::cout : out);
+  for (const std::string &res : results) {
+    os << res << '\n';
+  }
+
+  os.flush();
+
+  return os.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int solve(const Options &options) {
+  return forEachPuzzle(options, [](const Puzzle & /*puzzle*/,
+                                   algorithm::CandidateSolver &solver) {
+    if (solver.solve() == 0u) {
+      return algorithm::toString(solver.status());
+    }
+
+    return toString(solver.solution());
+  });
+}
+
+int count(const Options &options) {
+  unsigned limit = options.limit;
+
+  return forEachPuzzle(
+      options, [limit](const Puzzle & /*puzzle*/,
+                       algorithm::CandidateSolver &solver) {
+        return std::to_string(solver.solve(limit));
+      });
+}
+
+int grade(const Options &options) {
+  return forEachPuzzle(options, [](const Puzzle &puzzle,
+                                   algorithm::CandidateSolver &solver) {
+    algorithm::Status status = solver.status();
+
+    std::string level = "-";
+    if (status == algorithm::Status::Unique) {
+      level = sudoku::toString(solver.difficulty());
+    }
+
+    return algorithm::toString(status) + " " + level + " " +
+           std::to_string(clues(puzzle.grid)) + " " +
+           std::to_string(solver.nodes()) + " " +
+           std::to_string(solver.guesses());
+  });
+}
+
+int generate(const Options &options) {
+  std::vector<std::string> results(options.count);
+  unsigned digits = toClues(options.level);
+
+  // Each puzzle uses its own seed: this gives distinct puzzles
+  // which can be generated again whatever the number of threads.
+  unsigned seed = options.seed;
+  if (seed == 0u) {
+    seed = std::random_device()();
+  }
+
+  parallelFor(options.count, threadsCount(options),
+              [&results, digits, seed](unsigned id) {
+                utils::RNG rng(static_cast<int>(seed + id));
+
+                Board board;
+                if (!board.generate(digits, rng)) {
+                  return;
+                }
+
+                algorithm::Grid grid;
+                for (unsigned y = 0u; y < board.h(); ++y) {
+                  for (unsigned x = 0u; x < board.w(); ++x) {
+                    grid[y * board.w() + x] =
+                        static_cast<std::uint8_t>(board.at(x, y));
+                  }
+                }
+
+                results[id] = toString(grid);
+              });
+
+  std::ofstream out;
+  if (options.output != "-") {
+    out.open(options.output);
+    if (!out.good()) {
+      std::cerr << "Failed to open \"" << options.output << "\"" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::ostream &os = (options.output == "-" ? std::cout : out);
+  for (const std::string &res : results) {
+    if (!res.empty()) {
+      os << res << '\n';
+    }
+  }
+
+  os.flush();
+
+  return os.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int bench(const Options &options) {
+  std::ifstream file;
+  if (options.input != "-") {
+    file.open(options.input);
+    if (!file.good()) {
+      std::cerr << "Failed to open \"" << options.input << "\"" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<Puzzle> puzzles =
+      readPuzzles(options.input == "-" ? std::cin : file);
+
+  unsigned total = puzzles.size() * options.repeat;
+  unsigned threads = threadsCount(options);
+  std::atomic<unsigned> solved(0u);
+
+  auto start = std::chrono::steady_clock::now();
+
+  parallelFor(total, threads, [&puzzles, &solved](unsigned id) {
+    const Puzzle &p = puzzles[id % puzzles.size()];
+    if (!p.valid) {
+      return;
+    }
+
+    algorithm::CandidateSolver solver;
+    solver.load(p.grid);
+    if (solver.solve() > 0u) {
+      solved.fetch_add(1u);
+    }
+  });
+
+  auto end = std::chrono::steady_clock::now();
+  double ms =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  double rate = (ms > 0.0 ? 1000.0 * total / ms : 0.0);
+
+  std::ofstream out;
+  if (options.output != "-") {
+    out.open(options.output);
+  }
+
+  std::ostream &os = (options.output == "-" ? std::cout : out);
+  os << "Solved " << solved.load() << "/" << total << " puzzle(s) in " << ms
+     << " ms using " << threads << " thread(s): " << rate << " puzzles/s"
+     << std::endl;
+
+  return os.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace
+
+std::string usage() {
+  return "Usage: sudoku-cli <command> [options]\n"
+         "\n"
+         "Commands:\n"
+         "  solve      print the solution of each puzzle\n"
+         "  generate   generate new puzzles\n"
+         "  count      print the number of solutions of each puzzle\n"
+         "  grade      print the status, difficulty, clues, nodes and\n"
+         "             guesses needed to solve each puzzle\n"
+         "  bench      measure the throughput of the solver\n"
+         "\n"
+         "Puzzles are read one per line as 81 characters where empty\n"
+         "cells are represented by '0' or '.'.\n"
+         "\n"
+         "Options:\n"
+         "  -i, --input <file>    read puzzles from file (default: stdin)\n"
+         "  -o, --output <file>   write results to file (default: stdout)\n"
+         "  -j, --threads <n>     number of threads (default: all cores)\n"
+         "  -n, --count <n>       number of puzzles to generate\n"
+         "  -l, --level <level>   easy, medium or hard (default: medium)\n"
+         "  -s, --seed <n>        seed of the first puzzle to generate\n"
+         "                        (default: random)\n"
+         "      --limit <n>       maximum number of solutions to count\n"
+         "      --repeat <n>      number of runs of each puzzle in bench\n"
+         "  -h, --help            display this message\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options,
+                  std::string &reason) {
+  if (argc < 2) {
+    reason = "No command specified";
+    return false;
+  }
+
+  options.command = argv[1];
+  if (options.command == "-h" || options.command == "--help") {
+    return true;
+  }
+
+  if (options.command != "solve" && options.command != "generate" &&
+      options.command != "count" && options.command != "grade" &&
+      options.command != "bench") {
+    reason = "Unknown command \"" + options.command + "\"";
+    return false;
+  }
+
+  for (int id = 2; id < argc; ++id) {
+    std::string arg = argv[id];
+
+    if (arg == "-h" || arg == "--help") {
+      options.command = "--help";
+      return true;
+    }
+
+    if (id + 1 >= argc) {
+      reason = "Missing value for option \"" + arg + "\"";
+      return false;
+    }
+
+    std::string value = argv[++id];
+    bool valid = true;
+
+    if (arg == "-i" || arg == "--input") {
+      options.input = value;
+    } else if (arg == "-o" || arg == "--output") {
+      options.output = value;
+    } else if (arg == "-j" || arg == "--threads") {
+      valid = parseUnsigned(value, options.threads, maxThreads);
+    } else if (arg == "-n" || arg == "--count") {
+      valid = parseUnsigned(value, options.count);
+    } else if (arg == "-l" || arg == "--level") {
+      valid = parseLevel(value, options.level);
+    } else if (arg == "-s" || arg == "--seed") {
+      valid = parseUnsigned(value, options.seed);
+    } else if (arg == "--limit") {
+      valid = parseUnsigned(value, options.limit);
+    } else if (arg == "--repeat") {
+      valid = parseUnsigned(value, options.repeat) && options.repeat > 0u;
+    } else {
+      reason = "Unknown option \"" + arg + "\"";
+      return false;
+    }
+
+    if (!valid) {
+      reason = "Invalid value \"" + value + "\" for option \"" + arg + "\"";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int run(const Options &options) {
+  if (options.command == "--help" || options.command == "-h") {
+    std::cout << usage();
+    return EXIT_SUCCESS;
+  }
+
+  if (options.command == "solve") {
+    return solve(options);
+  }
+  if (options.command == "generate") {
+    return generate(options);
+  }
+  if (options.command == "count") {
+    return count(options);
+  }
+  if (options.command == "grade") {
+    return grade(options);
+  }
+
+  return bench(options);
+}
+
+} // namespace sudoku::cli
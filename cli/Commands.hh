@@ -0,0 +1,69 @@
+#ifndef COMMANDS_HH
+#define COMMANDS_HH
+
+#include "Board.hh"
+#include <string>
+
+namespace sudoku::cli {
+
+/// @brief - The options controlling the execution of a command.
+/// Puzzles are read one per line as 81 characters where empty
+/// cells are represented by `0` or `.`.
+struct Options {
+  // The command to execute.
+  std::string command{};
+
+  // The file to read puzzles from (`-` for the standard input).
+  std::string input{"-"};
+
+  // The file to write results to (`-` for the standard output).
+  std::string output{"-"};
+
+  // The number of threads to use (`0` to use all the cores).
+  unsigned threads{0u};
+
+  // The number of puzzles to generate.
+  unsigned count{1u};
+
+  // The difficulty of the puzzles to generate.
+  Level level{Level::Medium};
+
+  // The seed of the first generated puzzle, the next ones using the
+  // following seeds (`0` to pick a random one).
+  unsigned seed{0u};
+
+  // The maximum number of solutions to count for a puzzle.
+  unsigned limit{1000u};
+
+  // The number of times each puzzle is solved when benchmarking.
+  unsigned repeat{1u};
+};
+
+/**
+ * @brief - Generate the help message describing the commands and
+ *          the options.
+ * @return - the help message.
+ */
+std::string usage();
+
+/**
+ * @brief - Parse the command line arguments into options.
+ * @param argc - the number of arguments.
+ * @param argv - the arguments (including the program name).
+ * @param options - output argument receiving the options.
+ * @param reason - output argument describing the failure if any.
+ * @return - `true` if the arguments are valid.
+ */
+bool parseOptions(int argc, char **argv, Options &options,
+                  std::string &reason);
+
+/**
+ * @brief - Execute the command described by the input options.
+ * @param options - the options of the command.
+ * @return - the exit code of the program.
+ */
+int run(const Options &options);
+
+} // namespace sudoku::cli
+
+#endif /* COMMANDS_HH */
@@ -0,0 +1,39 @@
+
+/// @brief - A headless front-end to the sudoku engine.
+
+#include "Commands.hh"
+#include <core_utils/CoreException.hh>
+#include <core_utils/log/Locator.hh>
+#include <core_utils/log/PrefixedLogger.hh>
+#include <core_utils/log/StdLogger.hh>
+#include <iostream>
+
+int main(int argc, char **argv) {
+  // Create the logger: only report problems so that the
+  // output of the commands is not polluted.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::WARNING);
+  utils::log::PrefixedLogger logger("cli", "main");
+  utils::log::Locator::provide(&raw);
+
+  sudoku::cli::Options options;
+  std::string reason;
+  if (!sudoku::cli::parseOptions(argc, argv, options, reason)) {
+    std::cerr << reason << "\n\n" << sudoku::cli::usage();
+    return EXIT_FAILURE;
+  }
+
+  try {
+    return sudoku::cli::run(options);
+  } catch (const utils::CoreException &e) {
+    logger.error("Caught internal exception while running command",
+                 e.what());
+  } catch (const std::exception &e) {
+    logger.error("Caught internal exception while running command",
+                 e.what());
+  } catch (...) {
+    logger.error("Unexpected error while running command");
+  }
+
+  return EXIT_FAILURE;
+}
@@ -1,13 +1,17 @@
 
 /// @brief - A sudoku solver.
 
+#include "Allocations.hh"
 #include "App.hh"
 #include "AppDesc.hh"
+#include "Metrics.hh"
 #include "TopViewFrame.hh"
+#include "Trace.hh"
 #include <core_utils/CoreException.hh>
 #include <core_utils/log/Locator.hh>
 #include <core_utils/log/PrefixedLogger.hh>
 #include <core_utils/log/StdLogger.hh>
+#include <cstdlib>
 
 /// TODO: Hint in main game.
 /// https://github.com/cyrixmorten/sudoku/tree/master/src/solver/solverStrategies
@@ -20,6 +24,21 @@ int main(int /*argc*/, char ** /*argv*/) {
   utils::log::PrefixedLogger logger("pge", "main");
   utils::log::Locator::provide(&raw);
 
+  // Record the timeline of the frames so that it can be dumped
+  // on demand (see `PGEApp::dumpTrace`).
+  sudoku::trace::enable(true);
+
+  // Counting the allocations is opt-in as it slows down all of them:
+  // the counters are displayed in the debug layer.
+  const char *countAllocations = std::getenv("SUDOKU_COUNT_ALLOCATIONS");
+  if (countAllocations != nullptr && std::string(countAllocations) == "1") {
+    sudoku::allocations::enable(true);
+  }
+
+  // Export the metrics so that they can be collected by the
+  // textfile collector of the node exporter.
+  sudoku::metrics::registry().startFlushing("data/metrics.prom", 15000u);
+
   try {
     logger.notice("Starting application");
 
@@ -45,5 +64,7 @@ int main(int /*argc*/, char ** /*argv*/) {
     logger.error("Unexpected error while setting up application");
   }
 
+  sudoku::metrics::registry().stopFlushing();
+
   return EXIT_SUCCESS;
 }
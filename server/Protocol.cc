@@ -0,0 +1,80 @@
+
+#include "Protocol.hh"
+
+namespace sudoku::server {
+namespace {
+
+void writeId(std::uint32_t id, char *buf) noexcept {
+  // Always use little endian.
+  for (unsigned b = 0u; b < 4u; ++b) {
+    buf[b] = static_cast<char>((id >> (8u * b)) & 0xFFu);
+  }
+}
+
+std::uint32_t readId(const char *buf) noexcept {
+  std::uint32_t id = 0u;
+  for (unsigned b = 0u; b < 4u; ++b) {
+    id |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(buf[b]))
+          << (8u * b);
+  }
+
+  return id;
+}
+
+void pack(const algorithm::Grid &grid, char *buf) noexcept {
+  for (unsigned id = 0u; id < gridBytes; ++id) {
+    unsigned low = grid[2u * id];
+    unsigned high =
+        (2u * id + 1u < counting::cellsCount ? grid[2u * id + 1u] : 0u);
+
+    buf[id] = static_cast<char>((low & 0xFu) | ((high & 0xFu) << 4u));
+  }
+}
+
+bool unpack(const char *buf, algorithm::Grid &grid) noexcept {
+  for (unsigned cell = 0u; cell < counting::cellsCount; ++cell) {
+    std::uint8_t b = static_cast<std::uint8_t>(buf[cell / 2u]);
+    unsigned digit = (cell % 2u == 0u ? b & 0xFu : b >> 4u);
+
+    if (digit > counting::candidates) {
+      return false;
+    }
+
+    grid[cell] = static_cast<std::uint8_t>(digit);
+  }
+
+  return true;
+}
+
+} // namespace
+
+bool decode(const char *buf, Request &request) noexcept {
+  if (static_cast<std::uint8_t>(buf[0]) != solveRequest) {
+    return false;
+  }
+
+  request.id = readId(buf + 1u);
+
+  return unpack(buf + 5u, request.puzzle);
+}
+
+void encode(const Response &response, char *buf) noexcept {
+  buf[0] = static_cast<char>(solveResponse);
+  writeId(response.id, buf + 1u);
+
+  buf[5] = static_cast<char>(response.status);
+  buf[6] = static_cast<char>(response.status == algorithm::Status::Unique
+                                 ? static_cast<std::uint8_t>(response.level)
+                                 : noGrade);
+
+  pack(response.solution, buf + 7u);
+}
+
+std::string key(const algorithm::Grid &grid) {
+  std::string out(gridBytes, '\0');
+  pack(grid, out.data());
+
+  return out;
+}
+
+} // namespace sudoku::server
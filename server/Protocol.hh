@@ -0,0 +1,82 @@
+#ifndef PROTOCOL_HH
+#define PROTOCOL_HH
+
+#include "CandidateSolver.hh"
+#include <cstdint>
+#include <string>
+
+namespace sudoku::server {
+
+/// @brief - The number of bytes needed to store a grid where each
+/// digit takes 4 bits.
+constexpr unsigned gridBytes = (counting::cellsCount + 1u) / 2u;
+
+/// @brief - The type of the frames exchanged with the server.
+constexpr std::uint8_t solveRequest = 0x01u;
+constexpr std::uint8_t solveResponse = 0x81u;
+
+/// @brief - The size of a request frame: the type, the identifier
+/// of the request and the packed puzzle.
+constexpr unsigned requestSize = 1u + 4u + gridBytes;
+
+/// @brief - The size of a response frame: the type, the identifier
+/// of the request, the status, the grade and the packed solution.
+constexpr unsigned responseSize = 1u + 4u + 1u + 1u + gridBytes;
+
+/// @brief - The value of the grade for puzzles which don't have a
+/// unique solution.
+constexpr std::uint8_t noGrade = 0xFFu;
+
+/// @brief - A request to solve a puzzle.
+struct Request {
+  // The identifier of the request, chosen by the client and sent
+  // back with the response.
+  std::uint32_t id;
+
+  // The puzzle to solve.
+  algorithm::Grid puzzle;
+};
+
+/// @brief - The answer to a request.
+struct Response {
+  // The identifier of the request.
+  std::uint32_t id;
+
+  // Whether the puzzle has no, one or several solutions.
+  algorithm::Status status;
+
+  // The estimated difficulty of the puzzle: only relevant when
+  // the solution is unique.
+  Level level;
+
+  // The solution found (empty if the puzzle can't be solved).
+  algorithm::Grid solution;
+};
+
+/**
+ * @brief - Decode a request from the input buffer which is assumed
+ *          to contain at least `requestSize` bytes.
+ * @param buf - the buffer to decode.
+ * @param request - output argument receiving the request.
+ * @return - `false` if the frame is not a valid request.
+ */
+bool decode(const char *buf, Request &request) noexcept;
+
+/**
+ * @brief - Encode the response in the input buffer which is assumed
+ *          to be able to hold `responseSize` bytes.
+ * @param response - the response to encode.
+ * @param buf - the buffer to write to.
+ */
+void encode(const Response &response, char *buf) noexcept;
+
+/**
+ * @brief - Generate a compact key identifying the input puzzle.
+ * @param grid - the puzzle.
+ * @return - the packed representation of the grid.
+ */
+std::string key(const algorithm::Grid &grid);
+
+} // namespace sudoku::server
+
+#endif /* PROTOCOL_HH */
@@ -0,0 +1,56 @@
+
+#include "ResultCache.hh"
+
+namespace sudoku::server {
+
+ResultCache::ResultCache(unsigned capacity)
+    : m_capacity(capacity), m_entries(), m_index(), m_hits(0u),
+      m_misses(0u) {
+  m_index.reserve(capacity);
+}
+
+bool ResultCache::find(const std::string &key, Response &response) {
+  auto it = m_index.find(key);
+  if (it == m_index.end()) {
+    ++m_misses;
+    return false;
+  }
+
+  ++m_hits;
+
+  // Move the entry at the front of the list.
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+  std::uint32_t id = response.id;
+  response = it->second->second;
+  response.id = id;
+
+  return true;
+}
+
+void ResultCache::insert(const std::string &key, const Response &response) {
+  if (m_capacity == 0u) {
+    return;
+  }
+
+  auto it = m_index.find(key);
+  if (it != m_index.end()) {
+    it->second->second = response;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return;
+  }
+
+  if (m_entries.size() >= m_capacity) {
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+  }
+
+  m_entries.emplace_front(key, response);
+  m_index.emplace(key, m_entries.begin());
+}
+
+unsigned long ResultCache::hits() const noexcept { return m_hits; }
+
+unsigned long ResultCache::misses() const noexcept { return m_misses; }
+
+} // namespace sudoku::server
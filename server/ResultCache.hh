@@ -0,0 +1,84 @@
+#ifndef RESULT_CACHE_HH
+#define RESULT_CACHE_HH
+
+#include "Protocol.hh"
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace sudoku::server {
+
+/// @brief - Keeps the responses to the most recently requested
+/// puzzles. When the cache is full the least recently used entry
+/// is evicted. This class is not thread-safe.
+class ResultCache {
+public:
+  /**
+   * @brief - Create a new cache holding at most the specified
+   *          number of responses.
+   * @param capacity - the maximum number of entries.
+   */
+  ResultCache(unsigned capacity);
+
+  /**
+   * @brief - Search for the response to the puzzle identified by
+   *          the input key. The entry is marked as recently used.
+   * @param key - the key of the puzzle.
+   * @param response - output argument receiving the response. Its
+   *                   identifier is left untouched.
+   * @return - `true` if the response was found.
+   */
+  bool find(const std::string &key, Response &response);
+
+  /**
+   * @brief - Register the response for the puzzle identified by
+   *          the input key.
+   * @param key - the key of the puzzle.
+   * @param response - the response to the puzzle.
+   */
+  void insert(const std::string &key, const Response &response);
+
+  /**
+   * @brief - The number of lookups which found a response.
+   * @return - the number of hits.
+   */
+  unsigned long hits() const noexcept;
+
+  /**
+   * @brief - The number of lookups which did not find a response.
+   * @return - the number of misses.
+   */
+  unsigned long misses() const noexcept;
+
+private:
+  /// @brief - An entry of the cache.
+  using Entry = std::pair<std::string, Response>;
+
+  /// @brief - The entries ordered from the most recently used.
+  using Entries = std::list<Entry>;
+
+  /**
+   * @brief - The maximum number of entries.
+   */
+  unsigned m_capacity;
+
+  /**
+   * @brief - The entries of the cache.
+   */
+  Entries m_entries;
+
+  /**
+   * @brief - Allows to find the entry for a given key.
+   */
+  std::unordered_map<std::string, Entries::iterator> m_index;
+
+  /**
+   * @brief - Statistics about the lookups.
+   */
+  unsigned long m_hits;
+  unsigned long m_misses;
+};
+
+} // namespace sudoku::server
+
+#endif /* RESULT_CACHE_HH */
@@ -0,0 +1,420 @@
+
+#include "Server.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace sudoku::server {
+namespace {
+
+/// @brief - The maximum duration of a wait for events, so that
+/// stop requests are noticed.
+constexpr int pollTimeoutMs = 250;
+
+/// @brief - The size of the buffer used to read from clients.
+constexpr unsigned readBufferSize = 64u * 1024u;
+
+/// @brief - The amount of responses waiting to be sent to a client
+/// above which no more requests are read from it.
+constexpr std::size_t maxBacklog = 1024u * 1024u;
+
+bool setNonBlocking(int fd) noexcept {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+Response process(algorithm::CandidateSolver &solver, const Request &request) {
+  Response out;
+
+  out.id = request.id;
+  out.status = algorithm::Status::Invalid;
+  out.level = Level::Easy;
+  out.solution.fill(0u);
+
+  if (!solver.load(request.puzzle)) {
+    return out;
+  }
+
+  out.status = solver.status();
+  if (out.status == algorithm::Status::Unique ||
+      out.status == algorithm::Status::Multiple) {
+    out.solution = solver.solution();
+  }
+  if (out.status == algorithm::Status::Unique) {
+    out.level = solver.difficulty();
+  }
+
+  return out;
+}
+
+} // namespace
+
+Server::Server(const Config &config)
+    : utils::CoreObject("server"),
+
+      m_config(config), m_listener(-1), m_wakeup(-1), m_connections(),
+      m_nextConnection(0u), m_cache(config.cacheSize), m_pending(),
+      m_locker(), m_waiter(), m_running(true), m_batches(), m_results(),
+      m_workers(), m_served(0u) {
+  setService("sudoku");
+
+  if (m_config.socket.size() >= sizeof(sockaddr_un::sun_path)) {
+    error("Failed to create server", "Socket path \"" + m_config.socket +
+                                         "\" is too long");
+  }
+  if (m_config.batchSize == 0u) {
+    m_config.batchSize = 1u;
+  }
+
+  m_wakeup = eventfd(0, EFD_NONBLOCK);
+  if (m_wakeup < 0) {
+    error("Failed to create server", std::strerror(errno));
+  }
+
+  m_listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (m_listener < 0) {
+    error("Failed to create server", std::strerror(errno));
+  }
+
+  // Remove any stale socket left by a previous instance.
+  unlink(m_config.socket.c_str());
+
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, m_config.socket.c_str(),
+               sizeof(addr.sun_path) - 1u);
+
+  if (bind(m_listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) <
+          0 ||
+      ::listen(m_listener, SOMAXCONN) < 0 || !setNonBlocking(m_listener)) {
+    std::string reason = std::strerror(errno);
+    close(m_listener);
+    close(m_wakeup);
+    error("Failed to listen on \"" + m_config.socket + "\"", reason);
+  }
+
+  unsigned threads = m_config.threads;
+  if (threads == 0u) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  for (unsigned id = 0u; id < threads; ++id) {
+    m_workers.emplace_back(&Server::work, this);
+  }
+
+  info("Listening on \"" + m_config.socket + "\" with " +
+       std::to_string(threads) + " worker(s)");
+}
+
+Server::~Server() {
+  {
+    const std::lock_guard<std::mutex> guard(m_locker);
+    m_running = false;
+  }
+
+  m_waiter.notify_all();
+  for (std::thread &t : m_workers) {
+    t.join();
+  }
+
+  for (auto &conn : m_connections) {
+    close(conn.second.fd);
+  }
+
+  close(m_listener);
+  close(m_wakeup);
+  unlink(m_config.socket.c_str());
+
+  info("Served " + std::to_string(m_served) + " request(s), " +
+       std::to_string(m_cache.hits()) + " from the cache");
+}
+
+void Server::run(const std::atomic<bool> &stop) {
+  std::vector<pollfd> fds;
+  std::vector<std::uint64_t> ids;
+
+  while (!stop.load()) {
+    fds.clear();
+    ids.clear();
+
+    fds.push_back(pollfd{m_listener, POLLIN, 0});
+    fds.push_back(pollfd{m_wakeup, POLLIN, 0});
+
+    for (const auto &conn : m_connections) {
+      short events = 0;
+      if (conn.second.reading && !backlogged(conn.second)) {
+        events |= POLLIN;
+      }
+      if (conn.second.written < conn.second.out.size()) {
+        events |= POLLOUT;
+      }
+
+      fds.push_back(pollfd{conn.second.fd, events, 0});
+      ids.push_back(conn.first);
+    }
+
+    int ready = poll(fds.data(), fds.size(), pollTimeoutMs);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      error("Failed to wait for events", std::strerror(errno));
+    }
+
+    if (fds[1].revents & POLLIN) {
+      std::uint64_t count;
+      while (::read(m_wakeup, &count, sizeof(count)) > 0) {
+        // Drain the counter.
+      }
+
+      collect();
+    }
+
+    if (fds[0].revents & POLLIN) {
+      accept();
+    }
+
+    for (unsigned id = 0u; id < ids.size(); ++id) {
+      auto it = m_connections.find(ids[id]);
+      if (it == m_connections.end()) {
+        continue;
+      }
+
+      Connection &conn = it->second;
+      short events = fds[id + 2u].revents;
+      bool keep = true;
+
+      if (events & POLLIN) {
+        keep = read(it->first, conn);
+      }
+      if (keep && conn.written < conn.out.size()) {
+        keep = write(conn);
+      }
+
+      // A hang up means that the client is gone entirely (a
+      // shutdown of its sending side only is reported as the
+      // end of the stream by `read`): responses can't reach it
+      // anymore.
+      if (events & (POLLHUP | POLLERR)) {
+        keep = false;
+      }
+
+      // Once the client is done sending requests, the connection
+      // is kept until all of them were answered.
+      if (!conn.reading && conn.inFlight == 0u &&
+          conn.written >= conn.out.size()) {
+        debug("Client done with connection " + std::to_string(it->first));
+        keep = false;
+      }
+
+      if (!keep) {
+        close(it->second.fd);
+        m_connections.erase(it);
+      }
+    }
+
+    dispatch();
+  }
+}
+
+void Server::accept() {
+  int fd;
+  while ((fd = ::accept(m_listener, nullptr, nullptr)) >= 0) {
+    if (!setNonBlocking(fd)) {
+      close(fd);
+      continue;
+    }
+
+    m_connections.emplace(m_nextConnection,
+                          Connection{fd, std::vector<char>(),
+                                     std::vector<char>(), 0u, true, 0u});
+    ++m_nextConnection;
+
+    debug("Accepted connection " + std::to_string(m_nextConnection - 1u));
+  }
+}
+
+bool Server::read(std::uint64_t id, Connection &conn) {
+  char buf[readBufferSize];
+
+  while (conn.reading && !backlogged(conn)) {
+    ssize_t count = ::read(conn.fd, buf, sizeof(buf));
+
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      return false;
+    }
+
+    if (count == 0) {
+      // The client won't send more requests: the ones already
+      // received are still answered.
+      conn.reading = false;
+    }
+
+    conn.in.insert(conn.in.end(), buf, buf + count);
+
+    // Decode all the complete frames: the requests which were
+    // already answered are replied to right away.
+    std::size_t offset = 0u;
+    while (conn.in.size() - offset >= requestSize) {
+      Job job;
+      job.connection = id;
+
+      if (!decode(conn.in.data() + offset, job.request)) {
+        warn("Closing connection " + std::to_string(id),
+             "Received invalid frame");
+        return false;
+      }
+
+      offset += requestSize;
+
+      Response res;
+      res.id = job.request.id;
+      if (m_cache.find(key(job.request.puzzle), res)) {
+        reply(conn, res);
+      } else {
+        m_pending.push_back(job);
+        ++conn.inFlight;
+      }
+    }
+
+    conn.in.erase(conn.in.begin(), conn.in.begin() + offset);
+  }
+
+  return true;
+}
+
+bool Server::backlogged(const Connection &conn) noexcept {
+  std::size_t queued = conn.out.size() - conn.written;
+  return queued + conn.inFlight * responseSize >= maxBacklog;
+}
+
+bool Server::write(Connection &conn) {
+  while (conn.written < conn.out.size()) {
+    ssize_t count = send(conn.fd, conn.out.data() + conn.written,
+                         conn.out.size() - conn.written, MSG_NOSIGNAL);
+
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      // Drop what was already sent: a client reading slowly
+      // would otherwise keep the buffer growing.
+      conn.out.erase(conn.out.begin(), conn.out.begin() + conn.written);
+      conn.written = 0u;
+
+      return true;
+    }
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      return false;
+    }
+
+    conn.written += static_cast<std::size_t>(count);
+  }
+
+  conn.out.clear();
+  conn.written = 0u;
+
+  return true;
+}
+
+void Server::reply(Connection &conn, const Response &response) {
+  std::size_t size = conn.out.size();
+  conn.out.resize(size + responseSize);
+  encode(response, conn.out.data() + size);
+
+  ++m_served;
+}
+
+void Server::dispatch() {
+  if (m_pending.empty()) {
+    return;
+  }
+
+  {
+    const std::lock_guard<std::mutex> guard(m_locker);
+
+    for (std::size_t start = 0u; start < m_pending.size();
+         start += m_config.batchSize) {
+      std::size_t end =
+          std::min<std::size_t>(start + m_config.batchSize, m_pending.size());
+      m_batches.emplace_back(m_pending.begin() + start,
+                             m_pending.begin() + end);
+    }
+  }
+
+  m_pending.clear();
+  m_waiter.notify_all();
+}
+
+void Server::collect() {
+  std::vector<Result> results;
+  {
+    const std::lock_guard<std::mutex> guard(m_locker);
+    std::swap(results, m_results);
+  }
+
+  for (const Result &res : results) {
+    // Cache the response even if the client is gone.
+    m_cache.insert(res.key, res.response);
+
+    auto it = m_connections.find(res.connection);
+    if (it != m_connections.end()) {
+      --it->second.inFlight;
+      reply(it->second, res.response);
+    }
+  }
+}
+
+void Server::work() {
+  algorithm::CandidateSolver solver;
+  std::vector<Result> results;
+
+  std::unique_lock<std::mutex> lock(m_locker);
+
+  while (true) {
+    m_waiter.wait(lock, [this]() { return !m_running || !m_batches.empty(); });
+
+    if (!m_running) {
+      return;
+    }
+
+    Batch batch = std::move(m_batches.front());
+    m_batches.pop_front();
+
+    // Solve the puzzles without holding the lock.
+    lock.unlock();
+
+    results.clear();
+    for (const Job &job : batch) {
+      results.push_back(Result{job.connection, key(job.request.puzzle),
+                               process(solver, job.request)});
+    }
+
+    lock.lock();
+    m_results.insert(m_results.end(), results.begin(), results.end());
+
+    notify();
+  }
+}
+
+void Server::notify() noexcept {
+  std::uint64_t one = 1u;
+  ssize_t count = ::write(m_wakeup, &one, sizeof(one));
+  (void)count;
+}
+
+} // namespace sudoku::server
@@ -0,0 +1,242 @@
+#ifndef SERVER_HH
+#define SERVER_HH
+
+#include "Protocol.hh"
+#include "ResultCache.hh"
+#include <atomic>
+#include <condition_variable>
+#include <core_utils/CoreObject.hh>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sudoku::server {
+
+/// @brief - The configuration of the server.
+struct Config {
+  // The path to the Unix socket to listen on.
+  std::string socket{"/tmp/sudoku.sock"};
+
+  // The number of threads solving puzzles (`0` to use all the
+  // cores).
+  unsigned threads{0u};
+
+  // The maximum number of responses kept in the cache.
+  unsigned cacheSize{65536u};
+
+  // The maximum number of requests handed to a worker at once.
+  unsigned batchSize{64u};
+};
+
+/// @brief - Serves requests to solve puzzles received on a Unix
+/// socket. A single thread handles all the connections: it answers
+/// from the cache when possible and otherwise groups the requests
+/// received together into batches processed by a pool of workers.
+class Server : public utils::CoreObject {
+public:
+  /**
+   * @brief - Create the server, listen on the socket and start the
+   *          workers.
+   * @param config - the configuration of the server.
+   */
+  Server(const Config &config);
+
+  /**
+   * @brief - Stop the workers, close the connections and remove
+   *          the socket.
+   */
+  ~Server();
+
+  /**
+   * @brief - Serve the requests until the input flag is set.
+   * @param stop - set to `true` to stop the server.
+   */
+  void run(const std::atomic<bool> &stop);
+
+private:
+  /// @brief - The state of a connection with a client.
+  struct Connection {
+    // The file descriptor of the connection.
+    int fd;
+
+    // The data received and not yet decoded.
+    std::vector<char> in;
+
+    // The data to send to the client.
+    std::vector<char> out;
+
+    // The number of bytes of `out` already sent.
+    std::size_t written;
+
+    // Whether the client may still send requests: it is reset
+    // when the client shuts down its side of the connection.
+    bool reading;
+
+    // The number of requests handed to the workers and whose
+    // response was not yet queued in `out`.
+    std::size_t inFlight;
+  };
+
+  /// @brief - A request waiting to be processed by a worker.
+  struct Job {
+    // The identifier of the connection the request comes from.
+    std::uint64_t connection;
+
+    // The request to process.
+    Request request;
+  };
+
+  /// @brief - The response computed by a worker for a job.
+  struct Result {
+    // The identifier of the connection to send the response to.
+    std::uint64_t connection;
+
+    // The key of the puzzle, used to cache the response.
+    std::string key;
+
+    // The response to send.
+    Response response;
+  };
+
+  /// @brief - A group of jobs handed to a worker at once.
+  using Batch = std::vector<Job>;
+
+  /**
+   * @brief - Accept the pending connections.
+   */
+  void accept();
+
+  /**
+   * @brief - Read the data available on the connection and decode
+   *          the requests it contains. Reading stops as long as
+   *          the responses not yet sent to the client exceed a
+   *          threshold, so that a client which never reads can't
+   *          make the server buffer an unbounded amount of data.
+   * @param id - the identifier of the connection.
+   * @param conn - the connection to read from.
+   * @return - `false` if the connection should be closed.
+   */
+  bool read(std::uint64_t id, Connection &conn);
+
+  /**
+   * @brief - Whether the responses queued for the client or still
+   *          computed by the workers exceed the threshold above
+   *          which no more requests are read.
+   * @param conn - the connection to check.
+   * @return - `true` if reading from the client should pause.
+   */
+  static bool backlogged(const Connection &conn) noexcept;
+
+  /**
+   * @brief - Send as much of the pending responses as possible.
+   * @param conn - the connection to write to.
+   * @return - `false` if the connection should be closed.
+   */
+  bool write(Connection &conn);
+
+  /**
+   * @brief - Append the response to the data to send to a client.
+   * @param conn - the connection to send the response to.
+   * @param response - the response to send.
+   */
+  void reply(Connection &conn, const Response &response);
+
+  /**
+   * @brief - Hand the requests waiting for a worker in batches.
+   */
+  void dispatch();
+
+  /**
+   * @brief - Fetch the responses computed by the workers and queue
+   *          them for sending.
+   */
+  void collect();
+
+  /**
+   * @brief - The main loop of the workers.
+   */
+  void work();
+
+  /**
+   * @brief - Wake up the thread handling the connections.
+   */
+  void notify() noexcept;
+
+private:
+  /**
+   * @brief - The configuration of the server.
+   */
+  Config m_config;
+
+  /**
+   * @brief - The socket accepting connections.
+   */
+  int m_listener;
+
+  /**
+   * @brief - Used by the workers to signal that responses are
+   *          available.
+   */
+  int m_wakeup;
+
+  /**
+   * @brief - The open connections and the identifier of the next
+   *          one.
+   */
+  std::unordered_map<std::uint64_t, Connection> m_connections;
+  std::uint64_t m_nextConnection;
+
+  /**
+   * @brief - The recent responses. Only accessed by the thread
+   *          handling the connections.
+   */
+  ResultCache m_cache;
+
+  /**
+   * @brief - The requests decoded but not yet dispatched.
+   */
+  Batch m_pending;
+
+  /**
+   * @brief - Protects the data shared with the workers.
+   */
+  std::mutex m_locker;
+
+  /**
+   * @brief - Notified when batches are available or when the
+   *          workers should stop.
+   */
+  std::condition_variable m_waiter;
+
+  /**
+   * @brief - Whether the workers should keep running.
+   */
+  bool m_running;
+
+  /**
+   * @brief - The batches waiting for a worker.
+   */
+  std::deque<Batch> m_batches;
+
+  /**
+   * @brief - The responses computed by the workers.
+   */
+  std::vector<Result> m_results;
+
+  /**
+   * @brief - The pool of workers.
+   */
+  std::vector<std::thread> m_workers;
+
+  /**
+   * @brief - The number of requests served.
+   */
+  unsigned long m_served;
+};
+
+} // namespace sudoku::server
+
+#endif /* SERVER_HH */
@@ -0,0 +1,112 @@
+
+/// @brief - A daemon serving requests to solve puzzles over a
+/// Unix socket.
+
+#include "Arguments.hh"
+#include "Server.hh"
+#include <core_utils/CoreException.hh>
+#include <core_utils/log/Locator.hh>
+#include <core_utils/log/PrefixedLogger.hh>
+#include <core_utils/log/StdLogger.hh>
+#include <csignal>
+#include <iostream>
+
+namespace {
+
+/// @brief - Set when the daemon is asked to stop.
+std::atomic<bool> stopRequested(false);
+
+void onSignal(int /*signal*/) { stopRequested.store(true); }
+
+std::string usage() {
+  return "Usage: sudoku-serverd [options]\n"
+         "\n"
+         "Options:\n"
+         "  -s, --socket <path>   the Unix socket to listen on\n"
+         "                        (default: /tmp/sudoku.sock)\n"
+         "  -j, --threads <n>     number of workers (default: all cores)\n"
+         "      --cache <n>       number of responses to cache\n"
+         "      --batch <n>       maximum requests per batch\n"
+         "  -h, --help            display this message\n";
+}
+
+bool parseOptions(int argc, char **argv, sudoku::server::Config &config,
+                  bool &help) {
+  for (int id = 1; id < argc; ++id) {
+    std::string arg = argv[id];
+
+    if (arg == "-h" || arg == "--help") {
+      help = true;
+      return true;
+    }
+
+    if (id + 1 >= argc) {
+      return false;
+    }
+
+    std::string value = argv[++id];
+    bool valid = true;
+
+    if (arg == "-s" || arg == "--socket") {
+      config.socket = value;
+    } else if (arg == "-j" || arg == "--threads") {
+      valid = sudoku::parseUnsigned(value, config.threads, sudoku::maxThreads);
+    } else if (arg == "--cache") {
+      valid = sudoku::parseUnsigned(value, config.cacheSize);
+    } else if (arg == "--batch") {
+      valid = sudoku::parseUnsigned(value, config.batchSize);
+    } else {
+      valid = false;
+    }
+
+    if (!valid) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Create the logger.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::INFO);
+  utils::log::PrefixedLogger logger("serverd", "main");
+  utils::log::Locator::provide(&raw);
+
+  sudoku::server::Config config;
+  bool help = false;
+  if (!parseOptions(argc, argv, config, help)) {
+    std::cerr << "Invalid arguments\n\n" << usage();
+    return EXIT_FAILURE;
+  }
+  if (help) {
+    std::cout << usage();
+    return EXIT_SUCCESS;
+  }
+
+  std::signal(SIGINT, onSignal);
+  std::signal(SIGTERM, onSignal);
+
+  try {
+    logger.notice("Starting server");
+
+    sudoku::server::Server server(config);
+    server.run(stopRequested);
+
+    logger.notice("Stopping server");
+  } catch (const utils::CoreException &e) {
+    logger.error("Caught internal exception while running server", e.what());
+    return EXIT_FAILURE;
+  } catch (const std::exception &e) {
+    logger.error("Caught internal exception while running server", e.what());
+    return EXIT_FAILURE;
+  } catch (...) {
+    logger.error("Unexpected error while running server");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
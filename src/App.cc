@@ -1,7 +1,23 @@
 
 # include "App.hh"
 
+# include <algorithm>
+# include <cmath>
+# include <cstdio>
 # include <core_utils/RNG.hh>
+# include "Allocations.hh"
+
+/// @brief - The size of the grid of the board in cells, including
+/// its outer border.
+# define GRID_SPAN 9.1f
+
+/// @brief - The maximum size in pixels of the sprite holding the
+/// grid of the board.
+# define MAX_GRID_SIZE 2048.0f
+
+/// @brief - The maximum length of a line of statistics displayed
+/// in the debug layer.
+# define STATS_LINE_LENGTH 96
 
 namespace pge {
 
@@ -12,8 +28,18 @@ namespace pge {
     m_state(nullptr),
     m_menus(),
 
-    m_packs(std::make_shared<TexturePack>())
-  {}
+    m_packs(std::make_shared<TexturePack>()),
+
+    m_statsLine(),
+
+    m_revisions(Revisions{nullptr, 0u, 0u, false, Screen::Home}),
+
+    m_glyphs(0u),
+
+    m_grid(GridCache{olc::vf2d(), olc::vf2d(1.0f, 1.0f), nullptr, nullptr})
+  {
+    m_statsLine.reserve(STATS_LINE_LENGTH);
+  }
 
   bool
   App::onFrame(float fElapsed) {
@@ -81,6 +107,27 @@ namespace pge {
         m_state->save();
       }
     }
+    if (c.keys[controls::keys::Z]) {
+      m_game->undo();
+    }
+    if (c.keys[controls::keys::Y]) {
+      m_game->redo();
+    }
+    if (c.keys[controls::keys::R]) {
+      m_game->togglePlayback();
+    }
+    if (c.keys[controls::keys::M]) {
+      m_game->togglePencil();
+    }
+    if (c.keys[controls::keys::A]) {
+      m_game->toggleMarks();
+    }
+    if (c.keys[controls::keys::PageUp]) {
+      m_game->scalePlaybackSpeed(2.0f);
+    }
+    if (c.keys[controls::keys::PageDown]) {
+      m_game->scalePlaybackSpeed(0.5f);
+    }
 
     for (unsigned id = 0u ; id < 10u ; ++id) {
       controls::keys::Keys key = static_cast<controls::keys::Keys>(controls::keys::Zero + id);
@@ -94,6 +141,46 @@ namespace pge {
     }
   }
 
+  void
+  App::detectChanges() {
+    if (m_game == nullptr || m_state == nullptr) {
+      return;
+    }
+
+    Screen screen = m_state->getScreen();
+    if (screen != m_revisions.screen) {
+      invalidate(Layer::DrawDecal);
+      invalidate(Layer::Draw);
+      invalidate(Layer::UI);
+      m_revisions.screen = screen;
+    }
+
+    const sudoku::Board& b = m_game->board();
+    if (&b != m_revisions.board || b.revision() != m_revisions.boardRevision) {
+      invalidate(Layer::DrawDecal);
+      m_revisions.board = &b;
+      m_revisions.boardRevision = b.revision();
+    }
+
+    // The partial solution changes at each frame while it is
+    // displayed, and should be erased once it is not anymore.
+    bool partial = (m_game->partialSolution() != nullptr);
+    if (partial || m_revisions.partial) {
+      invalidate(Layer::DrawDecal);
+      m_revisions.partial = partial;
+    }
+
+    unsigned long menus = m_state->revision();
+    for (unsigned id = 0u ; id < m_menus.size() ; ++id) {
+      menus += m_menus[id]->revision();
+    }
+    if (menus != m_revisions.menus) {
+      invalidate(Layer::Draw);
+      invalidate(Layer::UI);
+      m_revisions.menus = menus;
+    }
+  }
+
   void
   App::loadData() {
     // Create the game and its state.
@@ -115,6 +202,10 @@ namespace pge {
     // for now to achieve it.
     setLayerTint(Layer::Draw, olc::Pixel(255, 255, 255, alpha::SemiOpaque));
 
+    // Render the digits once: the board is then drawn
+    // as a textured quad per cell.
+    m_glyphs = m_packs->registerGlyphs(this, "123456789");
+
     info("Load app resources in the 'm_packs' attribute");
   }
 
@@ -135,6 +226,15 @@ namespace pge {
     if (m_packs != nullptr) {
       m_packs.reset();
     }
+
+    if (m_grid.decal != nullptr) {
+      delete m_grid.decal;
+      m_grid.decal = nullptr;
+    }
+    if (m_grid.sprite != nullptr) {
+      delete m_grid.sprite;
+      m_grid.sprite = nullptr;
+    }
   }
 
   void
@@ -207,6 +307,8 @@ namespace pge {
     SetPixelMode(olc::Pixel::ALPHA);
     Clear(olc::Pixel(255, 255, 255, alpha::Transparent));
 
+    drawFrameStats();
+
     // In case we're not in game mode, just render
     // the state.
     if (m_state->getScreen() != Screen::Game) {
@@ -230,52 +332,136 @@ namespace pge {
   }
 
   void
-  App::drawBoard(const RenderDesc& res) noexcept {
-    // Draw the outer border.
-    SpriteDesc sd = {};
-    sd.loc = pge::RelativePosition::Center;
-    sd.radius = 9.1f;
+  App::drawFrameStats() {
+    const FrameStats::Summary& fs = frameStats();
+
+    char buf[STATS_LINE_LENGTH];
+    int dOffset = 15;
+    olc::vi2d p(0, 2 * dOffset);
+
+    std::snprintf(
+      buf,
+      sizeof(buf),
+      "Frame p50/p95/p99 : %.1f / %.1f / %.1f ms (%u)",
+      fs.p50,
+      fs.p95,
+      fs.p99,
+      fs.frames
+    );
+    m_statsLine.assign(buf);
+    DrawString(p, m_statsLine, olc::CYAN);
+
+    p.y += dOffset;
+    std::snprintf(
+      buf,
+      sizeof(buf),
+      "Layers (ms)       : decal %.2f main %.2f ui %.2f debug %.2f",
+      fs.layers[static_cast<unsigned>(Layer::DrawDecal)],
+      fs.layers[static_cast<unsigned>(Layer::Draw)],
+      fs.layers[static_cast<unsigned>(Layer::UI)],
+      fs.layers[static_cast<unsigned>(Layer::Debug)]
+    );
+    m_statsLine.assign(buf);
+    DrawString(p, m_statsLine, olc::CYAN);
+
+    float solve = (m_game == nullptr ? -1.0f : m_game->lastSolveDuration());
+    p.y += dOffset;
+    if (solve < 0.0f) {
+      std::snprintf(buf, sizeof(buf), "Last solve        : none");
+    }
+    else {
+      std::snprintf(buf, sizeof(buf), "Last solve        : %.2f ms", solve);
+    }
+    m_statsLine.assign(buf);
+    DrawString(p, m_statsLine, olc::CYAN);
+
+    p.y += dOffset;
+    if (!sudoku::allocations::enabled()) {
+      std::snprintf(buf, sizeof(buf), "Allocations       : not counted");
+    }
+    else {
+      std::snprintf(
+        buf,
+        sizeof(buf),
+        "Allocations       : %.1f/frame (max %llu) solve %llu generate %llu",
+        fs.allocations,
+        static_cast<unsigned long long>(fs.maxAllocations),
+        static_cast<unsigned long long>(sudoku::allocations::of(sudoku::allocations::Category::Solve).count),
+        static_cast<unsigned long long>(sudoku::allocations::of(sudoku::allocations::Category::Generate).count)
+      );
+    }
+    m_statsLine.assign(buf);
+    DrawString(p, m_statsLine, olc::CYAN);
+  }
 
-    sd.x = 4.5f;
-    sd.y = 4.5f;
+  void
+  App::bakeGrid(const olc::vf2d& tileSize) {
+    if (m_grid.decal != nullptr) {
+      delete m_grid.decal;
+    }
+    if (m_grid.sprite != nullptr) {
+      delete m_grid.sprite;
+    }
 
-    sd.sprite.tint = olc::BLACK;
+    // The grid spans 9 cells and its outer border
+    // extends slightly beyond them.
+    olc::vf2d ts(
+      std::min(tileSize.x, MAX_GRID_SIZE / GRID_SPAN),
+      std::min(tileSize.y, MAX_GRID_SIZE / GRID_SPAN)
+    );
 
-    drawRect(sd, res.cf);
+    m_grid.tileSize = tileSize;
+    m_grid.scale = tileSize / ts;
 
-    // Draw the cells.
-    sd = {};
-    sd.loc = pge::RelativePosition::Center;
-    sd.radius = 8.9f;
+    int w = std::max(1, static_cast<int>(std::ceil(GRID_SPAN * ts.x)));
+    int h = std::max(1, static_cast<int>(std::ceil(GRID_SPAN * ts.y)));
+    m_grid.sprite = new olc::Sprite(w, h);
 
-    sd.x = 4.5f;
-    sd.y = 4.5f;
+    // Fill a rectangle expressed in cells, where the
+    // origin is the top left corner of the grid. Each
+    // rectangle is at least one pixel wide so that the
+    // separators stay visible when zooming out.
+    auto fill = [this, &ts](float x, float y, float sx, float sy, const olc::Pixel& c) {
+      int xMin = static_cast<int>(std::round(x * ts.x));
+      int yMin = static_cast<int>(std::round(y * ts.y));
+      int xMax = static_cast<int>(std::round((x + sx) * ts.x));
+      int yMax = static_cast<int>(std::round((y + sy) * ts.y));
 
-    sd.sprite.tint = olc::WHITE;
+      FillRect(xMin, yMin, std::max(1, xMax - xMin), std::max(1, yMax - yMin), c);
+    };
 
-    drawRect(sd, res.cf);
+    olc::Sprite* base = GetDrawTarget();
+    SetDrawTarget(m_grid.sprite);
 
-    // Draw the horizontal borders.
-    olc::vf2d bigSz = olc::vf2d(9.1f, 0.1f) * res.cf.tileSize();
-    olc::vf2d smallSz = olc::vf2d(9.1f, 0.05f) * res.cf.tileSize();
-    for (unsigned y = 1u ; y < 9u ; ++y) {
-      olc::vf2d sz = (y % 3u != 0u ? smallSz : bigSz);
+    // Draw the outer border and the cells.
+    fill(0.0f, 0.0f, GRID_SPAN, GRID_SPAN, olc::BLACK);
+    fill(0.1f, 0.1f, 8.9f, 8.9f, olc::WHITE);
 
-      olc::vf2d p = res.cf.tileCoordsToPixels(0.45f, y + 0.5f, pge::RelativePosition::Center, 1.0f);
+    // Draw the horizontal and vertical separators:
+    // the ones delimiting the 3x3 regions are wider.
+    for (unsigned id = 1u ; id < 9u ; ++id) {
+      float thickness = (id % 3u != 0u ? 0.05f : 0.1f);
 
-      FillRectDecal(p, sz, olc::BLACK);
+      fill(0.0f, id + 0.05f, GRID_SPAN, thickness, olc::BLACK);
+      fill(id + 0.05f, 0.0f, thickness, GRID_SPAN, olc::BLACK);
     }
 
-    // Draw the vertical borders.
-    bigSz = olc::vf2d(0.1f, 9.1f) * res.cf.tileSize();
-    smallSz = olc::vf2d(0.05f, 9.1f) * res.cf.tileSize();
-    for (unsigned x = 1u ; x < 9u ; ++x) {
-      olc::vf2d sz = (x % 3u != 0u ? smallSz : bigSz);
+    SetDrawTarget(base);
 
-      olc::vf2d p = res.cf.tileCoordsToPixels(x + 0.5f, 0.45f, pge::RelativePosition::Center, 1.0f);
+    m_grid.decal = new olc::Decal(m_grid.sprite);
+  }
 
-      FillRectDecal(p, sz, olc::BLACK);
+  void
+  App::drawBoard(const RenderDesc& res) noexcept {
+    // The grid only depends on the size of the tiles:
+    // panning the view just moves it.
+    olc::vf2d ts = res.cf.tileSize();
+    if (m_grid.decal == nullptr || ts != m_grid.tileSize) {
+      bakeGrid(ts);
     }
+
+    olc::vf2d p = res.cf.tileCoordsToPixels(-0.05f, -0.05f);
+    DrawDecal(p, m_grid.decal, m_grid.scale);
   }
 
   void
@@ -283,6 +469,13 @@ namespace pge {
     float s = 2.2f;
     olc::vf2d scale(s, s);
 
+    // All the glyphs have the same size so the offset
+    // to center them in a cell is the same.
+    olc::vf2d offset = res.cf.tileSize() / 2.0f - olc::vf2d(8.0f, 8.0f) * scale / 2.0f;
+
+    sprites::Sprite glyph = {};
+    glyph.pack = m_glyphs;
+
     auto colorForDigit = [](const sudoku::DigitKind& kind) {
       switch (kind) {
         case sudoku::DigitKind::Generated:
@@ -298,31 +491,76 @@ namespace pge {
       }
     };
 
+    // The pencil marks are laid out on a 3x3 grid in each cell
+    // and scaled to fit in a third of the cell.
+    olc::vf2d markCell = res.cf.tileSize() / 3.0f;
+    float ms = 0.75f * std::min(markCell.x, markCell.y) / 8.0f;
+    olc::vf2d markScale(ms, ms);
+    olc::vf2d markOffset = markCell / 2.0f - olc::vf2d(8.0f, 8.0f) * markScale / 2.0f;
+
     const sudoku::Board& b = m_game->board();
+    const sudoku::algorithm::Grid* partial = m_game->partialSolution();
+    const sudoku::algorithm::Grid* backtracks = m_game->backtracks();
 
     for (unsigned y = 0u ; y < 9u ; ++y) {
       for (unsigned x = 0u ; x < 9u ; ++x) {
         sudoku::DigitKind kind;
         unsigned digit = b.at(x, y, &kind);
 
+        // Display the digits tried by the resolution in progress
+        // with a faded color. When the resolution is replayed the
+        // digits it put are displayed as solved ones, and those it
+        // removed in a distinct color.
+        olc::Pixel tint = colorForDigit(kind);
+        if (digit == 0u && partial != nullptr) {
+          digit = (*partial)[y * 9u + x];
+          tint = colorForDigit(sudoku::DigitKind::Solved);
+          if (backtracks == nullptr) {
+            tint.a = alpha::SemiOpaque;
+          }
+        }
+        if (digit == 0u && backtracks != nullptr) {
+          digit = (*backtracks)[y * 9u + x];
+          tint = olc::Pixel(olc::MAGENTA.r, olc::MAGENTA.g, olc::MAGENTA.b, alpha::SemiOpaque);
+        }
+
         if (digit == 0u) {
+          drawMarks(res, glyph, b.marks(x, y), x, y, markOffset, markScale);
           continue;
         }
 
-        std::string n = std::to_string(digit);
+        olc::vf2d p = res.cf.tileCoordsToPixels(x + 0.5f, y + 0.5f, pge::RelativePosition::Center, 1.0f);
 
-        olc::vf2d p(x + 0.5f, y + 0.5f);
-        p = res.cf.tileCoordsToPixels(p.x, p.y, pge::RelativePosition::Center, 1.0f);
+        glyph.sprite.x = digit - 1u;
+        glyph.tint = tint;
 
-        olc::vi2d sz = GetTextSize(n);
-        p -= sz * scale / 2.0f;
-        p += res.cf.tileSize() / 2.0f;
-
-        DrawStringDecal(p, n, colorForDigit(kind), scale);
+        m_packs->draw(this, glyph, p + offset, scale);
       }
     }
   }
 
+  void
+  App::drawMarks(const RenderDesc& res,
+                 sprites::Sprite& glyph,
+                 std::uint16_t marks,
+                 unsigned x,
+                 unsigned y,
+                 const olc::vf2d& offset,
+                 const olc::vf2d& scale) noexcept
+  {
+    glyph.tint = olc::GREY;
+
+    while (marks != 0u) {
+      unsigned id = __builtin_ctz(marks);
+      marks &= marks - 1u;
+
+      olc::vf2d p = res.cf.tileCoordsToPixels(x + (id % 3u) / 3.0f, y + (id / 3u) / 3.0f);
+
+      glyph.sprite.x = id;
+      m_packs->draw(this, glyph, p + offset, scale);
+    }
+  }
+
   void
   App::drawOverlays(const RenderDesc& res) noexcept {
     olc::vi2d mp = GetMousePos();
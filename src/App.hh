@@ -61,8 +61,49 @@ namespace pge {
       onInputs(const controls::State& c,
                const CoordinateFrame& cf) override;
 
+      /**
+       * @brief - Compare the revisions of the board, of the game
+       *          state and of the menus with the ones seen when
+       *          the layers were last drawn and invalidate the
+       *          layers displaying what changed.
+       */
+      void
+      detectChanges() override;
+
     private:
 
+      /// @brief - The revisions of the elements displayed by the
+      /// layers when they were last drawn.
+      struct Revisions {
+        // The board displayed and its revision.
+        const sudoku::Board* board;
+        unsigned long boardRevision;
+
+        // The sum of the revisions of the menus.
+        unsigned long menus;
+
+        // Whether a partial solution was displayed.
+        bool partial;
+
+        // The active screen.
+        Screen screen;
+      };
+
+      /// @brief - The grid of the board rendered offscreen.
+      struct GridCache {
+        // The size of a tile for which the grid was rendered.
+        olc::vf2d tileSize;
+
+        // The scale to apply to the decal to obtain the size of
+        // the grid: the resolution of the sprite is limited so
+        // that zooming in does not create huge textures.
+        olc::vf2d scale;
+
+        // The rendered grid and the decal used to draw it.
+        olc::Sprite* sprite;
+        olc::Decal* decal;
+      };
+
       /// @brief - Convenience structure regrouping needed props to
       /// draw a sprite.
       struct SpriteDesc {
@@ -114,15 +155,57 @@ namespace pge {
       drawRect(const SpriteDesc& t,
                const CoordinateFrame& cf);
 
+      /**
+       * @brief - Render the grid of the board (borders, cells and
+       *          separators) in an offscreen sprite for the input
+       *          size of a tile. The grid is then drawn as a single
+       *          decal until the size of the tiles changes.
+       * @param tileSize - the size of a tile in pixels.
+       */
+      void
+      bakeGrid(const olc::vf2d& tileSize);
+
       void
       drawBoard(const RenderDesc& res) noexcept;
 
       void
       drawNumbers(const RenderDesc& res) noexcept;
 
+      /**
+       * @brief - Draw the pencil marks of a cell from the glyphs
+       *          of the digits.
+       * @param res - the resources to draw.
+       * @param glyph - the sprite describing the glyphs, updated
+       *                for each mark.
+       * @param marks - the marks of the cell.
+       * @param x - the abscissa of the cell.
+       * @param y - the ordinate of the cell.
+       * @param offset - the offset to center a mark in its part of
+       *                 the cell.
+       * @param scale - the scale to apply to the glyphs.
+       */
+      void
+      drawMarks(const RenderDesc& res,
+                sprites::Sprite& glyph,
+                std::uint16_t marks,
+                unsigned x,
+                unsigned y,
+                const olc::vf2d& offset,
+                const olc::vf2d& scale) noexcept;
+
       void
       drawOverlays(const RenderDesc& res) noexcept;
 
+      /**
+       * @brief - Display the duration of the recent frames, the
+       *          cost of each layer and the duration of the last
+       *          resolution in the debug layer. The text is built
+       *          in a preallocated buffer so that nothing gets
+       *          allocated at each frame.
+       */
+      void
+      drawFrameStats();
+
     private:
 
       /**
@@ -148,6 +231,30 @@ namespace pge {
        *          the elements of the game.
        */
       TexturePackShPtr m_packs;
+
+      /**
+       * @brief - The text of the line of statistics being drawn in
+       *          the debug layer. Its capacity is reserved once.
+       */
+      std::string m_statsLine;
+
+      /**
+       * @brief - The revisions of the displayed elements when the
+       *          layers were last drawn.
+       */
+      Revisions m_revisions;
+
+      /**
+       * @brief - The identifier of the pack holding the glyphs of
+       *          the digits, rendered once when loading resources.
+       */
+      unsigned m_glyphs;
+
+      /**
+       * @brief - The grid of the board, rendered again only when
+       *          the size of the tiles changes.
+       */
+      GridCache m_grid;
   };
 
 }
@@ -20,6 +20,11 @@ namespace pge {
 
         P,
         S,
+        Z,
+        Y,
+        R,
+        M,
+        A,
 
         Zero,
         One,
@@ -34,6 +39,9 @@ namespace pge {
 
         Del,
 
+        PageUp,
+        PageDown,
+
         KeysCount
       };
 
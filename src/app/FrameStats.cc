@@ -0,0 +1,98 @@
+
+# include "FrameStats.hh"
+# include <algorithm>
+
+namespace {
+
+  /**
+   * @brief - Return the value at the input percentile of the first
+   *          elements of the array. They are partially reordered.
+   * @param values - the values, reordered by this function.
+   * @param count - the number of values to consider.
+   * @param pct - the percentile in `[0; 1]`.
+   * @return - the value at the percentile.
+   */
+  float
+  percentile(std::array<float, pge::FrameStats::WINDOW>& values, unsigned count, float pct) noexcept {
+    unsigned id = static_cast<unsigned>(pct * (count - 1u) + 0.5f);
+    std::nth_element(values.begin(), values.begin() + id, values.begin() + count);
+
+    return values[id];
+  }
+
+}
+
+namespace pge {
+
+  FrameStats::FrameStats() noexcept:
+    m_frames(),
+    m_next(0u),
+    m_count(0u),
+
+    m_layers(),
+    m_current(),
+
+    m_allocations(),
+
+    m_sorted(),
+
+    m_summary(Summary{0.0f, 0.0f, 0.0f, {}, 0.0f, 0u, 0u}),
+    m_dirty(false)
+  {}
+
+  void
+  FrameStats::record(unsigned layer, float ms) noexcept {
+    if (layer < LAYERS) {
+      m_current[layer] += ms;
+    }
+  }
+
+  void
+  FrameStats::push(float ms, std::uint64_t allocations) noexcept {
+    m_frames[m_next] = ms;
+    m_layers[m_next] = m_current;
+    m_allocations[m_next] = allocations;
+    m_current.fill(0.0f);
+
+    m_next = (m_next + 1u) % WINDOW;
+    m_count = std::min(m_count + 1u, WINDOW);
+
+    m_dirty = true;
+  }
+
+  const FrameStats::Summary&
+  FrameStats::summary() noexcept {
+    if (!m_dirty || m_count == 0u) {
+      return m_summary;
+    }
+
+    std::copy(m_frames.begin(), m_frames.begin() + m_count, m_sorted.begin());
+
+    m_summary.p50 = percentile(m_sorted, m_count, 0.50f);
+    m_summary.p95 = percentile(m_sorted, m_count, 0.95f);
+    m_summary.p99 = percentile(m_sorted, m_count, 0.99f);
+
+    m_summary.layers.fill(0.0f);
+    std::uint64_t allocations = 0u;
+    m_summary.maxAllocations = 0u;
+
+    for (unsigned id = 0u ; id < m_count ; ++id) {
+      for (unsigned layer = 0u ; layer < LAYERS ; ++layer) {
+        m_summary.layers[layer] += m_layers[id][layer];
+      }
+
+      allocations += m_allocations[id];
+      m_summary.maxAllocations = std::max(m_summary.maxAllocations, m_allocations[id]);
+    }
+    for (unsigned layer = 0u ; layer < LAYERS ; ++layer) {
+      m_summary.layers[layer] /= m_count;
+    }
+    m_summary.allocations = static_cast<float>(allocations) / m_count;
+
+    m_summary.frames = m_count;
+    m_dirty = false;
+
+    return m_summary;
+  }
+
+}
@@ -0,0 +1,121 @@
+#ifndef    FRAME_STATS_HH
+# define   FRAME_STATS_HH
+
+# include <array>
+# include <cstdint>
+
+namespace pge {
+
+  /// @brief - Keeps the duration of the most recent frames, the time
+  /// spent drawing each layer and the number of allocations performed
+  /// during these frames. Everything is stored in fixed size buffers
+  /// so that recording a frame and computing the statistics never
+  /// allocates.
+  class FrameStats {
+    public:
+
+      /// @brief - The number of frames considered in the statistics.
+      static constexpr unsigned WINDOW = 240u;
+
+      /// @brief - The number of layers whose cost is tracked.
+      static constexpr unsigned LAYERS = 4u;
+
+      /// @brief - The statistics computed over the window.
+      struct Summary {
+        // The percentiles of the frame duration in milliseconds.
+        float p50;
+        float p95;
+        float p99;
+
+        // The average time spent drawing each layer during a
+        // frame in milliseconds.
+        std::array<float, LAYERS> layers;
+
+        // The average and maximum number of allocations performed
+        // during a frame.
+        float allocations;
+        std::uint64_t maxAllocations;
+
+        // The number of frames used to compute the statistics.
+        unsigned frames;
+      };
+
+      /**
+       * @brief - Create empty statistics.
+       */
+      FrameStats() noexcept;
+
+      /**
+       * @brief - Register time spent drawing a layer during the
+       *          current frame.
+       * @param layer - the index of the layer, must be lower than
+       *                `LAYERS`.
+       * @param ms - the duration in milliseconds.
+       */
+      void
+      record(unsigned layer, float ms) noexcept;
+
+      /**
+       * @brief - Complete the current frame: its duration, the cost
+       *          of its layers and its allocations replace the oldest
+       *          ones of the window.
+       * @param ms - the duration of the frame in milliseconds.
+       * @param allocations - the number of allocations performed
+       *                      during the frame.
+       */
+      void
+      push(float ms, std::uint64_t allocations) noexcept;
+
+      /**
+       * @brief - Compute the statistics over the window. They are
+       *          only computed again when a frame was pushed since
+       *          the last call.
+       * @return - the statistics.
+       */
+      const Summary&
+      summary() noexcept;
+
+    private:
+
+      /**
+       * @brief - The duration of the frames in the window and the
+       *          index of the next one to replace.
+       */
+      std::array<float, WINDOW> m_frames;
+      unsigned m_next;
+
+      /**
+       * @brief - The number of valid entries in the window.
+       */
+      unsigned m_count;
+
+      /**
+       * @brief - The cost of each layer for each frame of the
+       *          window, and for the frame in progress.
+       */
+      std::array<std::array<float, LAYERS>, WINDOW> m_layers;
+      std::array<float, LAYERS> m_current;
+
+      /**
+       * @brief - The number of allocations of each frame of the
+       *          window.
+       */
+      std::array<std::uint64_t, WINDOW> m_allocations;
+
+      /**
+       * @brief - Scratch buffer used to sort the frame durations
+       *          when computing the percentiles.
+       */
+      std::array<float, WINDOW> m_sorted;
+
+      /**
+       * @brief - The last statistics computed and whether they
+       *          are up to date.
+       */
+      Summary m_summary;
+      bool m_dirty;
+  };
+
+}
+
+#endif    /* FRAME_STATS_HH */
@@ -1,5 +1,45 @@
 
 # include "PGEApp.hh"
+# include <algorithm>
+# include <chrono>
+# include <thread>
+# include "Allocations.hh"
+# include "Metrics.hh"
+# include "Trace.hh"
+
+namespace {
+
+  /// @brief - The file receiving the events recorded by the tracing
+  /// when they are dumped.
+  constexpr auto traceFile = "data/trace.json";
+
+  /// @brief - The duration without any change after which the app
+  /// is considered idle, in milliseconds.
+  constexpr auto idleDelayMs = 1000;
+
+  /// @brief - The minimum duration of a frame when the app is idle
+  /// in milliseconds: this avoids spinning on a display which does
+  /// not change.
+  constexpr auto idleFrameMs = 100;
+
+  sudoku::metrics::Histogram&
+  frameDuration() {
+    static sudoku::metrics::Histogram& histogram = sudoku::metrics::registry().histogram(
+      "sudoku_frame_seconds",
+      "Time elapsed between two frames",
+      sudoku::metrics::exponentialBounds(0.001, 2.0, 11)
+    );
+
+    return histogram;
+  }
+
+  float
+  elapsedMs(const std::chrono::steady_clock::time_point& start) noexcept {
+    std::chrono::duration<float, std::milli> d = std::chrono::steady_clock::now() - start;
+    return d.count();
+  }
+
+}
 
 namespace pge {
 
@@ -19,7 +59,14 @@ namespace pge {
     m_first(true),
 
     m_fixedFrame(desc.fixedFrame),
-    m_frame(desc.frame)
+    m_frame(desc.frame),
+
+    m_stats(),
+    m_frameAllocations(0u),
+
+    m_layers(),
+    m_lastChange(std::chrono::steady_clock::now()),
+    m_idleTime(0.0f)
   {
     // Initialize the application settings.
     sAppName = desc.name;
@@ -39,6 +86,10 @@ namespace pge {
 
   bool
   PGEApp::OnUserCreate() {
+    // The engine calls this method and the update from its own
+    // thread: name it so that it is easy to find in the traces.
+    sudoku::trace::setThreadName("render");
+
     // The debug layer is the default layer: it is always
     // provided by the pixel game engine.
     m_dLayer = 0u;
@@ -69,14 +120,38 @@ namespace pge {
 
   bool
   PGEApp::OnUserUpdate(float fElapsedTime) {
+    sudoku::trace::Scope frame("frame", "render");
+    // The elapsed time includes the wait of the previous frame when
+    // the loop is slowed down: it would hide the actual cost of the
+    // frames in the statistics.
+    float elapsed = std::max(fElapsedTime - m_idleTime, 0.0f);
+    m_idleTime = 0.0f;
+
+    frameDuration().observe(elapsed);
+    // The allocations of the previous frame are complete: account
+    // for them before starting the new one.
+    std::uint64_t allocs = sudoku::allocations::of(sudoku::allocations::Category::Frame).count;
+    m_stats.push(1000.0f * elapsed, allocs - m_frameAllocations);
+    m_frameAllocations = allocs;
+
+    sudoku::allocations::Scope allocations(sudoku::allocations::Category::Frame);
+
     // Handle inputs.
-    InputChanges ic = handleInputs();
+    InputChanges ic;
+    {
+      sudoku::trace::Scope scope("inputs", "render");
+      ic = handleInputs();
 
-    // Handle user inputs.
-    onInputs(m_controls, *m_frame);
+      // Handle user inputs.
+      onInputs(m_controls, *m_frame);
+    }
 
     // Handle game logic.
-    bool quit = onFrame(fElapsedTime);
+    bool quit;
+    {
+      sudoku::trace::Scope scope("onFrame", "render");
+      quit = onFrame(fElapsedTime);
+    }
 
     // Handle rendering: for each function
     // we will assign the draw target first
@@ -90,19 +165,36 @@ namespace pge {
       *m_frame, // Coordinate frame
     };
 
+    // Only draw the layers whose content changed:
+    // any interaction of the user can change what
+    // is displayed so in this case we draw all of
+    // them. Otherwise it is up to the inheriting
+    // class to determine what changed.
+    if (ic.activity || isFirstFrame()) {
+      for (LayerCache& lc : m_layers) {
+        lc.dirty = true;
+      }
+    }
+    detectChanges();
+
     // Note that we usually need to clear
     // the layer at least once to `activate`
     // them: otherwise the window usually
     // stays black.
-    SetDrawTarget(m_mDecalLayer);
-    drawDecal(res);
+    bool changed = false;
+    {
+      sudoku::trace::Scope scope("drawDecal", "render");
+      changed |= renderLayer(Layer::DrawDecal, m_mDecalLayer, &PGEApp::drawDecal, res);
+    }
 
-    SetDrawTarget(m_mLayer);
-    draw(res);
+    {
+      sudoku::trace::Scope scope("draw", "render");
+      changed |= renderLayer(Layer::Draw, m_mLayer, &PGEApp::draw, res);
+    }
 
     if (hasUI()) {
-      SetDrawTarget(m_uiLayer);
-      drawUI(res);
+      sudoku::trace::Scope scope("drawUI", "render");
+      changed |= renderLayer(Layer::UI, m_uiLayer, &PGEApp::drawUI, res);
     }
     if (!hasUI() && isFirstFrame()) {
       SetDrawTarget(m_uiLayer);
@@ -121,9 +213,12 @@ namespace pge {
     // don't do this nothing will be visible
     // as the `0`-th layer would never be
     // updated.
+    // The debug information changes at each
+    // frame so it is always drawn.
     if (hasDebug()) {
-      SetDrawTarget(m_dLayer);
-      drawDebug(res);
+      sudoku::trace::Scope scope("drawDebug", "render");
+      invalidate(Layer::Debug);
+      renderLayer(Layer::Debug, m_dLayer, &PGEApp::drawDebug, res);
     }
     if (!hasDebug() && (ic.debugLayerToggled || isFirstFrame())) {
       SetDrawTarget(m_dLayer);
@@ -136,12 +231,27 @@ namespace pge {
     // Not the first frame anymore.
     m_first = false;
 
+    // When nothing changed for a while slow down
+    // the loop: there is no need to present the
+    // same content at the highest possible rate.
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (changed) {
+      m_lastChange = now;
+    }
+    if (now - m_lastChange > std::chrono::milliseconds(idleDelayMs)) {
+      sudoku::trace::Scope scope("idle", "render");
+      std::this_thread::sleep_for(std::chrono::milliseconds(idleFrameMs));
+
+      std::chrono::duration<float> idle = std::chrono::steady_clock::now() - now;
+      m_idleTime = idle.count();
+    }
+
     return !ic.quit && !quit;
   }
 
   PGEApp::InputChanges
   PGEApp::handleInputs() {
-    InputChanges ic{false, false};
+    InputChanges ic{false, false, false};
 
     // Detect press on `Escape` key to shutdown the app.
     olc::HWButton esc = GetKey(olc::ESCAPE);
@@ -165,9 +275,12 @@ namespace pge {
     }
 
     olc::vi2d mPos = GetMousePos();
+    ic.activity = (mPos.x != m_controls.mPosX || mPos.y != m_controls.mPosY);
     m_controls.mPosX = mPos.x;
     m_controls.mPosY = mPos.y;
 
+    ic.activity = (ic.activity || GetMouseWheel() != 0);
+
     if (!m_fixedFrame) {
       int scroll = GetMouseWheel();
       if (scroll > 0) {
@@ -202,6 +315,21 @@ namespace pge {
     b = GetKey(olc::S);
     m_controls.keys[controls::keys::S] = b.bReleased;
 
+    b = GetKey(olc::Z);
+    m_controls.keys[controls::keys::Z] = b.bReleased;
+
+    b = GetKey(olc::Y);
+    m_controls.keys[controls::keys::Y] = b.bReleased;
+
+    b = GetKey(olc::R);
+    m_controls.keys[controls::keys::R] = b.bReleased;
+
+    b = GetKey(olc::M);
+    m_controls.keys[controls::keys::M] = b.bReleased;
+
+    b = GetKey(olc::A);
+    m_controls.keys[controls::keys::A] = b.bReleased;
+
     b = GetKey(olc::DEL);
     m_controls.keys[controls::keys::Del] = b.bReleased;
 
@@ -251,6 +379,16 @@ namespace pge {
     b = GetKey(olc::NP9);
     m_controls.keys[controls::keys::Nine] = m_controls.keys[controls::keys::Nine] | b.bReleased;
 
+    b = GetKey(olc::PGUP);
+    m_controls.keys[controls::keys::PageUp] = b.bReleased;
+    b = GetKey(olc::NP_ADD);
+    m_controls.keys[controls::keys::PageUp] = m_controls.keys[controls::keys::PageUp] | b.bReleased;
+
+    b = GetKey(olc::PGDN);
+    m_controls.keys[controls::keys::PageDown] = b.bReleased;
+    b = GetKey(olc::NP_SUB);
+    m_controls.keys[controls::keys::PageDown] = m_controls.keys[controls::keys::PageDown] | b.bReleased;
+
     b = GetKey(olc::TAB),
     m_controls.tab = b.bReleased;
 
@@ -272,17 +410,77 @@ namespace pge {
     m_controls.buttons[controls::mouse::Right] = analysis(GetMouse(1));
     m_controls.buttons[controls::mouse::Middle] = analysis(GetMouse(2));
 
+    // Any key or button used by the app is considered
+    // as an interaction.
+    ic.activity = (ic.activity || m_controls.tab);
+    for (unsigned id = 0u ; id < m_controls.keys.size() ; ++id) {
+      ic.activity = (ic.activity || m_controls.keys[id]);
+    }
+    for (unsigned id = 0u ; id < m_controls.buttons.size() ; ++id) {
+      ic.activity = (ic.activity || m_controls.buttons[id] != controls::ButtonState::Free);
+    }
+
     // De/activate the debug mode if needed and
     // handle general simulation control options.
     if (GetKey(olc::D).bReleased) {
       m_debugOn = !m_debugOn;
       ic.debugLayerToggled = true;
+      ic.activity = true;
     }
     if (GetKey(olc::U).bReleased) {
       m_uiOn = !m_uiOn;
+      ic.activity = true;
+    }
+    if (GetKey(olc::T).bReleased) {
+      dumpTrace();
     }
 
     return ic;
   }
 
+  bool
+  PGEApp::renderLayer(const Layer& layer,
+                      uint32_t index,
+                      DrawLayer draw,
+                      const RenderDesc& res)
+  {
+    LayerCache& lc = m_layers[static_cast<unsigned>(layer)];
+    std::vector<olc::LayerDesc>& layers = GetLayers();
+
+    // The pixels of the layer are kept by the engine but
+    // not the decals: submit the ones recorded last time.
+    // Not setting the layer as draw target also prevents
+    // its texture from being uploaded again.
+    if (!lc.dirty) {
+      layers[index].vecDecalInstance = lc.decals;
+      return false;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    SetDrawTarget(index);
+    (this->*draw)(res);
+
+    lc.decals = layers[index].vecDecalInstance;
+    lc.dirty = false;
+
+    m_stats.record(static_cast<unsigned>(layer), elapsedMs(start));
+
+    return true;
+  }
+
+  void
+  PGEApp::dumpTrace() {
+    if (!sudoku::trace::dump(traceFile)) {
+      warn(
+        "Failed to dump trace",
+        std::string("Failed to write \"") + traceFile + "\""
+      );
+
+      return;
+    }
+
+    info(std::string("Dumped trace to \"") + traceFile + "\"");
+  }
+
 }
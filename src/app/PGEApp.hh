@@ -1,11 +1,15 @@
 #ifndef    PGE_APP_HH
 # define   PGE_APP_HH
 
+# include <array>
+# include <chrono>
+# include <vector>
 # include <core_utils/CoreObject.hh>
 # include "olcEngine.hh"
 # include "AppDesc.hh"
 # include "CoordinateFrame.hh"
 # include "Controls.hh"
+# include "FrameStats.hh"
 
 namespace pge {
 
@@ -119,6 +123,16 @@ namespace pge {
       bool
       hasUI() const noexcept;
 
+      /**
+       * @brief - Statistics about the most recent frames: the
+       *          percentiles of their duration and the time spent
+       *          drawing each layer. The cost of a layer is found
+       *          at the index corresponding to its `Layer` value.
+       * @return - the statistics of the recent frames.
+       */
+      const FrameStats::Summary&
+      frameStats() noexcept;
+
       /**
        * @brief - Used to assign a certain tint to the layer
        *          defined by the input descriptor.
@@ -129,6 +143,27 @@ namespace pge {
       void
       setLayerTint(const Layer& layer, const olc::Pixel& tint);
 
+      /**
+       * @brief - Request the input layer to be drawn again in the
+       *          current frame. Layers which are not invalidated
+       *          keep their content from the last time they were
+       *          drawn. All layers are invalidated on frames where
+       *          the user interacts with the app.
+       * @param layer - the layer to draw again.
+       */
+      void
+      invalidate(const Layer& layer) noexcept;
+
+      /**
+       * @brief - Interface method called at each frame before the
+       *          rendering so that inheriting classes can detect
+       *          the changes in the data they display and call
+       *          `invalidate` for the layers which need it. The
+       *          default implementation invalidates all layers.
+       */
+      virtual void
+      detectChanges();
+
       /**
        * @brief - Another interface method allowing to clear
        *          a rendering layer when it's disabled. This
@@ -263,6 +298,25 @@ namespace pge {
 
         // Whether the debug layer should be visible.
         bool debugLayerToggled;
+
+        // Whether the user interacted with the app in any way
+        // (mouse motion, click, key...).
+        bool activity;
+      };
+
+      /// @brief - The function drawing the content of a layer.
+      using DrawLayer = void (PGEApp::*)(const RenderDesc&);
+
+      /// @brief - The rendering information kept for each layer to
+      /// avoid drawing it again when its content did not change.
+      struct LayerCache {
+        // Whether the layer should be drawn in this frame.
+        bool dirty;
+
+        // The decals submitted the last time the layer was drawn.
+        // The engine discards them after each frame so they have
+        // to be submitted again when the layer is not drawn.
+        std::vector<olc::DecalInstance> decals;
       };
 
       /**
@@ -289,6 +343,29 @@ namespace pge {
       InputChanges
       handleInputs();
 
+      /**
+       * @brief - Write the events recorded by the tracing to a file
+       *          which can be opened with `chrome://tracing`.
+       */
+      void
+      dumpTrace();
+
+      /**
+       * @brief - Draw the input layer if it was invalidated, and
+       *          submit again the decals it produced last time it
+       *          was drawn otherwise.
+       * @param layer - the layer to render.
+       * @param index - the index of the layer in the engine.
+       * @param draw - the function drawing the layer.
+       * @param res - the resources to draw.
+       * @return - `true` if the layer was drawn.
+       */
+      bool
+      renderLayer(const Layer& layer,
+                  uint32_t index,
+                  DrawLayer draw,
+                  const RenderDesc& res);
+
     private:
 
       /**
@@ -367,6 +444,38 @@ namespace pge {
        *          screen coordinates and conversely.
        */
       CoordinateFrameShPtr m_frame;
+
+      /**
+       * @brief - The duration of the recent frames and the time
+       *          spent drawing each layer.
+       */
+      FrameStats m_stats;
+
+      /**
+       * @brief - The number of allocations attributed to the frames
+       *          when the current frame started.
+       */
+      std::uint64_t m_frameAllocations;
+
+      /**
+       * @brief - The rendering information of each layer, indexed
+       *          by the `Layer` value.
+       */
+      std::array<LayerCache, 4u> m_layers;
+
+      /**
+       * @brief - The last time a layer other than the debug one
+       *          was drawn. Used to slow down the rendering loop
+       *          when nothing changes.
+       */
+      std::chrono::steady_clock::time_point m_lastChange;
+
+      /**
+       * @brief - The time spent waiting at the end of the previous
+       *          frame to slow down the rendering loop, in seconds.
+       *          It is not part of the duration of the frame.
+       */
+      float m_idleTime;
   };
 
 }
@@ -44,6 +44,26 @@ namespace pge {
     return m_uiOn;
   }
 
+  inline
+  const FrameStats::Summary&
+  PGEApp::frameStats() noexcept {
+    return m_stats.summary();
+  }
+
+  inline
+  void
+  PGEApp::invalidate(const Layer& layer) noexcept {
+    m_layers[static_cast<unsigned>(layer)].dirty = true;
+  }
+
+  inline
+  void
+  PGEApp::detectChanges() {
+    for (LayerCache& lc : m_layers) {
+      lc.dirty = true;
+    }
+  }
+
   inline
   void
   PGEApp::setLayerTint(const Layer& layer, const olc::Pixel& tint) {
@@ -47,6 +47,39 @@ namespace pge {
     return id;
   }
 
+  unsigned
+  TexturePack::registerGlyphs(olc::PixelGameEngine* pge,
+                              const std::string& glyphs)
+  {
+    // The font of the engine uses 8x8 glyphs.
+    olc::vi2d sSize(8, 8);
+
+    olc::Sprite* spr = new olc::Sprite(sSize.x * glyphs.size(), sSize.y);
+
+    // Render the glyphs in the sprite and restore the
+    // draw target of the engine.
+    olc::Sprite* base = pge->GetDrawTarget();
+    pge->SetDrawTarget(spr);
+    pge->Clear(olc::BLANK);
+
+    for (unsigned id = 0u ; id < glyphs.size() ; ++id) {
+      pge->DrawString(olc::vi2d(id * sSize.x, 0), std::string(1u, glyphs[id]), olc::WHITE);
+    }
+
+    pge->SetDrawTarget(base);
+
+    Pack p;
+    p.sSize = sSize;
+    p.layout = olc::vi2d(glyphs.size(), 1);
+
+    p.res = new olc::Decal(spr);
+
+    unsigned id = m_packs.size();
+    m_packs.push_back(p);
+
+    return id;
+  }
+
   void
   TexturePack::draw(olc::PixelGameEngine* pge,
                     const sprites::Sprite& s,
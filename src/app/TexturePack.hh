@@ -79,6 +79,24 @@ namespace pge {
       unsigned
       registerPack(const sprites::Pack& pack);
 
+      /**
+       * @brief - Generate a pack containing each character of the
+       *          input string rendered once with the font of the
+       *          engine, in white so that they can be tinted when
+       *          drawn. The glyphs are laid out on a single line
+       *          in the order of the string: the glyph of the i-th
+       *          character is the sprite at coordinates `(i, 0)`.
+       *          This allows to draw text which is known ahead as
+       *          a single textured quad per character.
+       * @param pge - the engine to use to render the glyphs.
+       * @param glyphs - the characters to render.
+       * @return - an identifier allowing to reference this
+       *           pack for later use.
+       */
+      unsigned
+      registerGlyphs(olc::PixelGameEngine* pge,
+                     const std::string& glyphs);
+
       /**
        * @brief - Used to perform the drawing of the sprite as
        *          defined by the input argument using the engine.
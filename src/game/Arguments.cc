@@ -0,0 +1,30 @@
+
+#include "Arguments.hh"
+
+namespace sudoku {
+
+bool parseUnsigned(const std::string &str, unsigned &out,
+                   unsigned max) noexcept {
+  if (str.empty()) {
+    return false;
+  }
+
+  // Accumulate the digits while checking the range: the value might
+  // not fit in any integer type.
+  unsigned long long value = 0u;
+  for (char c : str) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+
+    value = 10u * value + static_cast<unsigned>(c - '0');
+    if (value > max) {
+      return false;
+    }
+  }
+
+  out = static_cast<unsigned>(value);
+  return true;
+}
+
+} // namespace sudoku
@@ -0,0 +1,28 @@
+#ifndef ARGUMENTS_HH
+#define ARGUMENTS_HH
+
+#include <climits>
+#include <string>
+
+namespace sudoku {
+
+/// @brief - The largest number of threads accepted on the command
+/// line of the tools: anything above is most likely a typo.
+constexpr unsigned maxThreads = 1024u;
+
+/**
+ * @brief - Parse a value of the command line as an unsigned integer.
+ *          Only digits are accepted and values above the maximum are
+ *          rejected rather than truncated.
+ * @param str - the value to parse.
+ * @param out - output argument receiving the value. It is left
+ *              unchanged when the value is invalid.
+ * @param max - the largest accepted value.
+ * @return - `true` if the value is valid.
+ */
+bool parseUnsigned(const std::string &str, unsigned &out,
+                   unsigned max = UINT_MAX) noexcept;
+
+} // namespace sudoku
+
+#endif /* ARGUMENTS_HH */
@@ -0,0 +1,42 @@
+
+#include "FileSync.hh"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <unistd.h>
+
+namespace sudoku {
+namespace {
+
+std::string sync(const std::string &path, int flags) {
+  int fd = ::open(path.c_str(), flags);
+  if (fd < 0) {
+    return std::strerror(errno);
+  }
+
+  std::string reason;
+  if (::fsync(fd) != 0) {
+    reason = std::strerror(errno);
+  }
+  ::close(fd);
+
+  return reason;
+}
+
+} // namespace
+
+std::string syncFile(const std::string &file) {
+  return sync(file, O_RDONLY);
+}
+
+std::string syncParentDirectory(const std::string &file) {
+  std::filesystem::path dir = std::filesystem::path(file).parent_path();
+  if (dir.empty()) {
+    dir = ".";
+  }
+
+  return sync(dir.string(), O_RDONLY | O_DIRECTORY);
+}
+
+} // namespace sudoku
@@ -0,0 +1,31 @@
+#ifndef FILE_SYNC_HH
+#define FILE_SYNC_HH
+
+#include <string>
+
+namespace sudoku {
+
+/**
+ * @brief - Flush the content of the input file to the disk. Used
+ *          before renaming a temporary file over its final name so
+ *          that a crash cannot leave an empty or truncated file in
+ *          place of the previous version.
+ * @param file - the path of the file to flush.
+ * @return - an empty string if the file could be flushed and the
+ *           reason of the failure otherwise.
+ */
+std::string syncFile(const std::string &file);
+
+/**
+ * @brief - Flush the directory containing the input file to the
+ *          disk, which makes the creation or the renaming of the
+ *          file durable.
+ * @param file - the path of the file whose directory is flushed.
+ * @return - an empty string if the directory could be flushed and
+ *           the reason of the failure otherwise.
+ */
+std::string syncParentDirectory(const std::string &file);
+
+} // namespace sudoku
+
+#endif /* FILE_SYNC_HH */
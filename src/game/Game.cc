@@ -1,9 +1,13 @@
 
 #include "Game.hh"
 #include "Menu.hh"
-#include "SudokuMatrix.hh"
+#include "Metrics.hh"
+#include "Trace.hh"
 #include <core_utils/Chrono.hh>
+#include <cstdio>
 #include <cxxabi.h>
+#include <limits>
+#include <thread>
 
 /// @brief - The height of the main menu.
 #define STATUS_MENU_HEIGHT 50
@@ -16,6 +20,22 @@
 /// solved.
 #define ALERT_DURATION_MS 3000
 
+/// @brief - The delay in milliseconds after which the
+/// generation of a puzzle is hurried: it then keeps more
+/// digits than expected for its level.
+#define GENERATION_TIMEOUT_MS 2000
+
+/// @brief - The time in microseconds given to the stepped
+/// solver in each frame: this keeps the frame rate close
+/// to 60 FPS.
+#define SOLVE_SLICE_US 4000
+
+/// @brief - The number of steps of a resolution replayed each
+/// second by default, and the bounds of this speed.
+#define PLAYBACK_SPEED 20.0f
+#define MIN_PLAYBACK_SPEED 1.0f
+#define MAX_PLAYBACK_SPEED 1000000.0f
+
 namespace {
 
 pge::MenuShPtr generateMenu(const olc::vi2d &pos, const olc::vi2d &size,
@@ -55,6 +75,30 @@ constexpr auto solverModeUnsolvableAlert = "Unsolvable !";
 
 constexpr auto interactiveModeSolvedAlert = "You solved the sudoku !";
 constexpr auto interactiveModeUnsolvableAlert = "There's probably a mistake !";
+
+constexpr auto journalFile = "data/saves.journal";
+
+constexpr auto savedAlert = "Game saved !";
+constexpr auto saveFailedAlert = "Failed to save game !";
+
+constexpr auto loadingMessage = "Generating puzzle...";
+
+sudoku::metrics::Histogram &solveDuration(const sudoku::Level &level) {
+  const std::string labels[] = {"level=\"easy\"", "level=\"medium\"",
+                                "level=\"hard\""};
+  std::size_t id = static_cast<std::size_t>(level);
+
+  return sudoku::metrics::registry().histogram(
+      "sudoku_solve_seconds", "Time spent solving a puzzle",
+      sudoku::metrics::exponentialBounds(0.001, 2.0, 14),
+      labels[id < 3u ? id : 1u]);
+}
+/// @brief - Whether the puzzles can be solved by a separate
+/// thread: on single core machines it would compete with the
+/// rendering so the search is spread over the frames instead.
+bool solveInBackground() noexcept {
+  return std::thread::hardware_concurrency() != 1u;
+}
 } // namespace
 
 namespace pge {
@@ -69,6 +113,8 @@ Game::Game()
           Mode::Solver,     // mode
           SolverStep::None, // solverStep
           false,            // done
+          false,            // pencil
+          false,            // marked
       }),
 
       m_menus(),
@@ -81,7 +127,54 @@ Game::Game()
           utils::TimeStamp(),      // since
           false,                   // active
           std::vector<MenuShPtr>() // menus
-      }) {
+      }),
+
+      m_save(SaveData{
+          std::make_shared<sudoku::SaveWorker>(), // worker
+          std::vector<sudoku::SaveWorker::Result>(), // results
+          utils::TimeStamp(), // succeeded
+          utils::TimeStamp(), // failed
+      }),
+
+      m_solve(SolveData{
+          // worker
+          solveInBackground() ? std::make_shared<sudoku::SolveWorker>()
+                              : nullptr,
+          // stepped
+          solveInBackground()
+              ? nullptr
+              : std::make_shared<sudoku::algorithm::SteppedSolver>(),
+          nullptr,                                 // log
+          0u,                                      // id
+          false,                                   // pending
+          std::weak_ptr<sudoku::Game>(),           // game
+          0u,                                      // revision
+          utils::TimeStamp(),                      // start
+      }),
+
+      m_generate(GenerateData{
+          std::make_shared<sudoku::GenerateWorker>(), // worker
+          0u,                                         // id
+          false,                                      // pending
+          utils::TimeStamp(),                         // start
+          false,                                      // hurried
+      }),
+
+      m_playback(PlaybackData{
+          false,                       // enabled
+          PLAYBACK_SPEED,              // speed
+          nullptr,                     // log
+          0u,                          // next
+          0.0f,                        // credit
+          sudoku::algorithm::Grid(),   // digits
+          sudoku::algorithm::Grid(),   // backtracks
+          false,                       // solved
+          sudoku::algorithm::Grid(),   // solution
+      }),
+
+      m_journal(std::make_shared<sudoku::Journal>(journalFile)),
+
+      m_lastSolve(-1.0f) {
   setService("game");
 }
 
@@ -101,6 +194,8 @@ std::vector<MenuShPtr> Game::generateMenus(float width, float height) {
 
   // The list of remaining numbers
   m_menus.digits.resize(9u);
+  // Force the update of the menus on the first frame.
+  m_menus.counts.assign(9u, std::numeric_limits<unsigned>::max());
 
   m_menus.digits[0u] = generateMenu(pos, dims, "1s: 9", "ones", BUTTON_BG);
   m_menus.status->addMenu(m_menus.digits[0u]);
@@ -121,9 +216,20 @@ std::vector<MenuShPtr> Game::generateMenus(float width, float height) {
   m_menus.digits[8u] = generateMenu(pos, dims, "9s: 9", "nines", BUTTON_BG);
   m_menus.status->addMenu(m_menus.digits[8u]);
 
-  MenuShPtr solve = generateMenu(pos, dims, "Solve", "solve", BUTTON_BG, true);
-  solve->setSimpleAction([](Game &g) { g.solve(); });
-  m_menus.status->addMenu(solve);
+  // The solve buttons also allow to cancel a resolution
+  // in progress.
+  auto toggleSolve = [](Game &g) {
+    if (g.solving()) {
+      g.cancelSolve();
+    } else {
+      g.solve();
+    }
+  };
+
+  m_menus.quickSolve =
+      generateMenu(pos, dims, "Solve", "solve", BUTTON_BG, true);
+  m_menus.quickSolve->setSimpleAction(toggleSolve);
+  m_menus.status->addMenu(m_menus.quickSolve);
 
   MenuShPtr reset = generateMenu(pos, dims, "Reset", "reset", BUTTON_BG, true);
   reset->setSimpleAction([](Game &g) { g.reset(); });
@@ -145,7 +251,7 @@ std::vector<MenuShPtr> Game::generateMenus(float width, float height) {
   // Generate the menus for the solver mode.
   m_menus.solve = generateMenu(pos, olc::vi2d(width, STATUS_MENU_HEIGHT),
                                "Solve !", "solve", olc::DARK_APPLE_GREEN, true);
-  m_menus.solve->setSimpleAction([](Game &g) { g.solve(); });
+  m_menus.solve->setSimpleAction(toggleSolve);
 
   m_menus.back = generateMenu(olc::vi2d(0, height - STATUS_MENU_HEIGHT),
                               olc::vi2d(width, STATUS_MENU_HEIGHT), "Back",
@@ -170,6 +276,29 @@ std::vector<MenuShPtr> Game::generateMenus(float width, float height) {
       olc::vi2d(300, 150), solverModeUnsolvableAlert, "unsolvable_alert", true);
   m_menus.unsolvableAlert.menu->setVisible(false);
 
+  m_menus.savedAlert.date = utils::TimeStamp();
+  m_menus.savedAlert.wasActive = false;
+  m_menus.savedAlert.duration = ALERT_DURATION_MS;
+
+  m_menus.savedAlert.menu = generateMessageBoxMenu(
+      olc::vi2d((width - 300.0f) / 2.0f, (height - 150.0f) / 2.0f),
+      olc::vi2d(300, 150), savedAlert, "saved_alert", false);
+  m_menus.savedAlert.menu->setVisible(false);
+
+  m_menus.saveFailedAlert.date = utils::TimeStamp();
+  m_menus.saveFailedAlert.wasActive = false;
+  m_menus.saveFailedAlert.duration = ALERT_DURATION_MS;
+
+  m_menus.saveFailedAlert.menu = generateMessageBoxMenu(
+      olc::vi2d((width - 300.0f) / 2.0f, (height - 150.0f) / 2.0f),
+      olc::vi2d(300, 150), saveFailedAlert, "save_failed_alert", true);
+  m_menus.saveFailedAlert.menu->setVisible(false);
+
+  m_menus.loading = generateMessageBoxMenu(
+      olc::vi2d((width - 300.0f) / 2.0f, (height - 150.0f) / 2.0f),
+      olc::vi2d(300, 150), loadingMessage, "loading", false);
+  m_menus.loading->setVisible(false);
+
   // Package menus for output.
   std::vector<MenuShPtr> menus;
 
@@ -182,6 +311,11 @@ std::vector<MenuShPtr> Game::generateMenus(float width, float height) {
   menus.push_back(m_menus.solvedAlert.menu);
   menus.push_back(m_menus.unsolvableAlert.menu);
 
+  menus.push_back(m_menus.savedAlert.menu);
+  menus.push_back(m_menus.saveFailedAlert.menu);
+
+  menus.push_back(m_menus.loading);
+
   return menus;
 }
 
@@ -266,7 +400,15 @@ void Game::performAction(float x, float y, bool erase) {
   }
 }
 
-bool Game::step(float /*tDelta*/) {
+bool Game::step(float tDelta) {
+  // Fetch the status of saves even when paused so that
+  // the results do not accumulate.
+  updateSaveStatus();
+  updateSolveStatus();
+  updatePlayback(tDelta);
+  updateGenerateStatus();
+  m_journal->flush();
+
   // When the game is paused it is not over yet.
   if (m_state.paused) {
     return true;
@@ -280,8 +422,10 @@ bool Game::step(float /*tDelta*/) {
 
   updateUI();
 
-  // Disable UI in case the game is done.
+  // Disable UI in case the game is done: there's no
+  // need to recover it anymore.
   if (m_state.done) {
+    m_journal->discard();
     pause();
     enable(!m_state.paused);
   }
@@ -296,7 +440,7 @@ void Game::togglePause() {
     pause();
   }
 
-  enable(!m_state.paused);
+  enable(!m_state.paused && !m_generate.pending);
 }
 
 void Game::setMode(const Mode &mode) noexcept {
@@ -315,13 +459,15 @@ void Game::setMode(const Mode &mode) noexcept {
   // Prevent the game from being done from the start.
   m_state.done = false;
 
+  attachJournal();
+
   resume();
-  enable(!m_state.paused);
+  enable(!m_state.paused && !m_generate.pending);
 }
 
 void Game::reset() {
   // Reset the sudoku game.
-  m_board->initialize();
+  generate();
 }
 
 void Game::clear() { m_board->clear(); }
@@ -329,8 +475,12 @@ void Game::clear() { m_board->clear(); }
 const sudoku::Board &Game::board() const noexcept { return (*m_board)(); }
 
 void Game::load(const std::string &file) {
+  // The puzzle being generated would replace the loaded one.
+  m_generate.pending = false;
+
   // Load the board.
   m_board->load(file);
+  m_state.marked = false;
 
   if (m_board->solved()) {
     debug("Board is now solved");
@@ -338,9 +488,10 @@ void Game::load(const std::string &file) {
   }
 }
 
-void Game::save(const std::string &file) const {
-  // Save the file including the number of moves and the score.
-  m_board->save(file);
+void Game::save(const std::string &file) {
+  // Snapshot the board and let the worker write it: this
+  // keeps slow file systems from stalling the rendering.
+  m_save.worker->save(file, board().pack(), m_board->metadata());
 }
 
 void Game::setActiveCell(float x, float y) {
@@ -386,6 +537,19 @@ void Game::resetActiveCell() {
 }
 
 void Game::onDigitPressed(unsigned digit) {
+  if (m_generate.pending) {
+    debug("Ignoring digit pressed, puzzle is being generated");
+    return;
+  }
+
+  if (m_state.pencil && digit != 0u && m_state.mode == Mode::Interactive) {
+    if (m_hint.x >= 0 && m_hint.y >= 0) {
+      m_board->toggleMark(m_hint.x, m_hint.y, digit);
+    }
+
+    return;
+  }
+
   // Early return if the digit if the same.
   const sudoku::Board &b = (*m_board)();
   if (b.at(m_hint.x, m_hint.y) == digit) {
@@ -416,12 +580,32 @@ void Game::onDigitPressed(unsigned digit) {
   }
 }
 
+void Game::togglePencil() noexcept {
+  m_state.pencil = !m_state.pencil;
+  info(std::string("Pencil mode is now ") +
+       (m_state.pencil ? "enabled" : "disabled"));
+}
+
+void Game::toggleMarks() {
+  if (m_state.disabled || m_state.mode != Mode::Interactive) {
+    return;
+  }
+
+  m_state.marked = !m_state.marked;
+
+  if (m_state.marked) {
+    m_board->fillMarks();
+  } else {
+    m_board->clearMarks();
+  }
+}
+
 void Game::setDifficultyLevel(const sudoku::Level &level) {
   m_board = std::make_shared<sudoku::Game>(level);
-  m_board->initialize();
+  attachJournal();
 
   resume();
-  enable(!m_state.paused);
+  generate();
 }
 
 void Game::solve() {
@@ -441,33 +625,156 @@ void Game::solve() {
     return;
   }
 
-  m_state.solverStep = SolverStep::Solving;
+  if (m_state.solverStep == SolverStep::Solving ||
+      m_state.solverStep == SolverStep::Replaying) {
+    debug("Ignoring solve request, sudoku is already being solved");
+    return;
+  }
 
-  std::stack<sudoku::algorithm::MatrixNode> nodes;
+  if (m_generate.pending) {
+    debug("Ignoring solve request, puzzle is being generated");
+    return;
+  }
 
+  // Snapshot the board and let the worker solve it: this
+  // keeps hard puzzles from stalling the rendering.
   const sudoku::Board &b = (*m_board)();
-  withSafetyNet(
-      [&nodes, &b]() {
-        utils::ChronoMilliseconds c("Solving Sudoku", "solver");
-        sudoku::algorithm::SudokuMatrix solver;
-        nodes = solver.solve(b);
-      },
-      "SudokuMatrix::solve");
-
-  if (nodes.empty()) {
-    m_state.solverStep = SolverStep::Unsolvable;
+
+  sudoku::algorithm::Grid grid;
+  for (unsigned y = 0u; y < 9u; ++y) {
+    for (unsigned x = 0u; x < 9u; ++x) {
+      grid[y * 9u + x] = static_cast<std::uint8_t>(b.at(x, y));
+    }
+  }
+
+  if (m_solve.worker != nullptr) {
+    m_solve.id = m_solve.worker->solve(grid, m_playback.enabled);
   } else {
+    m_solve.log = nullptr;
+    if (m_playback.enabled) {
+      m_solve.log = std::make_shared<sudoku::algorithm::StepLog>();
+    }
+
+    m_solve.stepped->record(m_solve.log.get());
+    m_solve.stepped->load(grid);
+    ++m_solve.id;
+  }
+
+  m_solve.pending = true;
+  m_solve.game = m_board;
+  m_solve.revision = b.revision();
+  m_solve.start = utils::now();
+
+  m_state.solverStep = SolverStep::Solving;
+}
+
+void Game::cancelSolve() {
+  // Cancelling a replay skips to its end.
+  if (m_state.solverStep == SolverStep::Replaying) {
+    finishPlayback();
+    return;
+  }
+
+  if (m_state.solverStep != SolverStep::Solving) {
+    return;
+  }
+
+  info("Cancelled resolution after " + std::to_string(exploredNodes()) +
+       " node(s)");
+
+  if (m_solve.worker != nullptr) {
+    m_solve.worker->cancel();
+  }
+  m_solve.pending = false;
+
+  m_state.solverStep = SolverStep::Preparing;
+}
+
+void Game::undo() {
+  if (m_state.disabled || m_state.mode != Mode::Interactive) {
+    return;
+  }
+
+  if (m_state.solverStep == SolverStep::Solved) {
+    warn("Ignoring undo request, sudoku is already solved");
+    return;
+  }
+
+  if (!m_board->undo()) {
+    debug("No move to undo");
+    return;
+  }
+
+  m_state.solverStep = SolverStep::Preparing;
+}
+
+void Game::redo() {
+  if (m_state.disabled || m_state.mode != Mode::Interactive) {
+    return;
+  }
+
+  if (m_state.solverStep == SolverStep::Solved) {
+    warn("Ignoring redo request, sudoku is already solved");
+    return;
+  }
+
+  if (!m_board->redo()) {
+    debug("No move to redo");
+    return;
+  }
+
+  m_state.solverStep = SolverStep::Preparing;
+  if (m_board->solved()) {
+    debug("Board is now solved");
     m_state.solverStep = SolverStep::Solved;
   }
+}
+
+bool Game::canRecover() const noexcept { return m_journal->recoverable(); }
+
+bool Game::recover() {
+  sudoku::GameShPtr board =
+      std::make_shared<sudoku::Game>(sudoku::Level::Medium);
+
+  if (!board->recover(m_journal)) {
+    warn("Failed to recover previous game");
+    return false;
+  }
+
+  m_board = board;
+  m_generate.pending = false;
+
+  return true;
+}
+
+void Game::generate() {
+  // Keep the player from interacting with the previous
+  // puzzle until the new one is available: the request
+  // returns right away so the rendering goes on.
+  m_board->clear();
+  m_state.marked = false;
+
+  m_generate.id = m_generate.worker->generate(m_board->level());
+  m_generate.pending = true;
+  m_generate.start = utils::now();
+  m_generate.hurried = false;
+
+  m_state.solverStep =
+      (m_state.mode == Mode::Interactive ? SolverStep::None
+                                         : SolverStep::Preparing);
 
-  // Fill in the puzzle.
-  while (!nodes.empty()) {
-    sudoku::algorithm::MatrixNode node = nodes.top();
-    nodes.pop();
+  enable(false);
+}
 
-    m_board->put(node.column(), node.row(), node.value(),
-                 sudoku::DigitKind::Solved);
+void Game::attachJournal() {
+  if (m_state.mode == Mode::Interactive) {
+    m_board->setJournal(m_journal);
+    return;
   }
+
+  // The solver mode does not need to be recovered.
+  m_board->setJournal(nullptr);
+  m_journal->discard();
 }
 
 void Game::enable(bool enable) {
@@ -492,41 +799,27 @@ void Game::updateUI() {
   }
 
   updateUIForSolver();
+  updateSolveButtons();
 }
 
 void Game::updateUIForInteractive() {
-  // Update digits count.
+  // Update the digits count: the board keeps track of them so
+  // only the menus whose count changed need to be updated.
   const sudoku::Board &b = (*m_board)();
 
-  unsigned count[9u];
-  for (unsigned id = 0u; id < 9u; ++id) {
-    count[id] = 0u;
-
-    unsigned digit = id + 1u;
-
-    for (unsigned y = 0u; y < b.h(); ++y) {
-      for (unsigned x = 0u; x < b.w(); ++x) {
-        if (b.at(x, y) == digit) {
-          ++count[id];
-        }
-      }
+  for (unsigned id = 0u; id < m_menus.digits.size(); ++id) {
+    unsigned count = b.count(id + 1u);
+    if (count == m_menus.counts[id]) {
+      continue;
     }
-  }
 
-  menu::BackgroundDesc all = pge::menu::newColoredBackground(olc::PALE_GREEN);
-  menu::BackgroundDesc missing =
-      pge::menu::newColoredBackground(olc::PALE_YELLOW);
+    m_menus.counts[id] = count;
 
-  for (unsigned id = 0u; id < m_menus.digits.size(); ++id) {
-    std::string txt =
-        std::to_string(id + 1u) + "s: " + std::to_string(count[id]);
+    std::string txt = std::to_string(id + 1u) + "s: " + std::to_string(count);
     m_menus.digits[id]->setText(txt);
 
-    if (count[id] == 9u) {
-      m_menus.digits[id]->setBackground(all);
-    } else {
-      m_menus.digits[id]->setBackground(missing);
-    }
+    olc::Pixel bg = (count == 9u ? olc::PALE_GREEN : olc::PALE_YELLOW);
+    m_menus.digits[id]->setBackground(pge::menu::newColoredBackground(bg));
   }
 
   for (unsigned id = 0u; id < m_hint.menus.size(); ++id) {
@@ -550,6 +843,12 @@ void Game::updateUIForSolver() {
       m_menus.solvedAlert.update(m_state.solverStep == SolverStep::Solved);
   m_menus.unsolvableAlert.update(m_state.solverStep == SolverStep::Unsolvable);
 
+  utils::TimeStamp now = utils::now();
+  m_menus.savedAlert.update(
+      now < m_save.succeeded + utils::toMilliseconds(ALERT_DURATION_MS));
+  m_menus.saveFailedAlert.update(
+      now < m_save.failed + utils::toMilliseconds(ALERT_DURATION_MS));
+
   if (m_state.mode == Mode::Interactive &&
       m_state.solverStep == SolverStep::Solved && !alertStillOn) {
     // The sudoku is solved and the menu is done.
@@ -557,6 +856,286 @@ void Game::updateUIForSolver() {
   }
 }
 
+void Game::updateSaveStatus() {
+  if (!m_save.worker->poll(m_save.results)) {
+    return;
+  }
+
+  for (const sudoku::SaveWorker::Result &res : m_save.results) {
+    if (res.success) {
+      info("Saved game to \"" + res.file + "\"");
+      m_save.succeeded = utils::now();
+      onGameSaved.safeEmit("game saved", res.file);
+    } else {
+      warn("Failed to save game to \"" + res.file + "\"");
+      m_save.failed = utils::now();
+    }
+  }
+}
+
+void Game::updateSolveStatus() {
+  bool changed = !sameBoardAsSolve();
+
+  sudoku::SolveWorker::Result res;
+  while (pollSolve(res, changed)) {
+    // Results of previous requests are not relevant.
+    if (!m_solve.pending || res.id != m_solve.id) {
+      continue;
+    }
+
+    m_solve.pending = false;
+
+    if (res.cancelled || m_state.solverStep != SolverStep::Solving) {
+      continue;
+    }
+    if (changed) {
+      warn("Discarding solution, board changed during the resolution");
+      m_state.solverStep = SolverStep::Preparing;
+      continue;
+    }
+
+    m_lastSolve = res.duration;
+    solveDuration(m_board->level()).observe(res.duration / 1000.0f);
+
+    if (res.log != nullptr) {
+      startPlayback(res);
+      continue;
+    }
+
+    if (!res.solved) {
+      warn("Puzzle not solvable after " + std::to_string(res.nodes) +
+           " node(s)");
+      m_state.solverStep = SolverStep::Unsolvable;
+      continue;
+    }
+
+    debug("Solved puzzle in " + std::to_string(res.nodes) + " node(s)");
+    m_state.solverStep = SolverStep::Solved;
+
+    fillSolution(res.solution);
+  }
+
+  // Stop searching if the result is not needed anymore.
+  if (m_solve.pending &&
+      (m_state.solverStep != SolverStep::Solving || changed)) {
+    if (m_solve.worker != nullptr) {
+      m_solve.worker->cancel();
+    }
+    m_solve.pending = false;
+
+    if (m_state.solverStep == SolverStep::Solving) {
+      m_state.solverStep = SolverStep::Preparing;
+    }
+  }
+}
+
+bool Game::sameBoardAsSolve() const noexcept {
+  // An expired game can't match: the current one is alive.
+  return m_solve.game.lock() == m_board &&
+         (*m_board)().revision() == m_solve.revision;
+}
+
+void Game::updateSolveButtons() {
+  char buf[64];
+
+  if (m_state.solverStep == SolverStep::Replaying) {
+    std::snprintf(buf, sizeof(buf), "Replaying: step %zu/%zu, skip ?",
+                  m_playback.next, m_playback.log->size());
+
+    m_menus.quickSolve->setText("Skip");
+    m_menus.solve->setText(buf);
+    return;
+  }
+
+  if (m_state.solverStep != SolverStep::Solving) {
+    m_menus.quickSolve->setText("Solve");
+    m_menus.solve->setText(m_playback.enabled ? "Solve and replay !"
+                                              : "Solve !");
+    return;
+  }
+
+  // Only display tenths of seconds so that the text does
+  // not change at each frame.
+  std::snprintf(buf, sizeof(buf), "Solving: %u node(s) in %.1fs, cancel ?",
+                exploredNodes(),
+                utils::diffInMs(m_solve.start, utils::now()) / 1000.0f);
+
+  m_menus.quickSolve->setText("Cancel");
+  m_menus.solve->setText(buf);
+}
+
+void Game::togglePlayback() {
+  m_playback.enabled = !m_playback.enabled;
+  info(std::string("Replay of resolutions is now ") +
+       (m_playback.enabled ? "enabled" : "disabled"));
+}
+
+void Game::scalePlaybackSpeed(float factor) {
+  m_playback.speed = std::clamp(m_playback.speed * factor,
+                                MIN_PLAYBACK_SPEED, MAX_PLAYBACK_SPEED);
+  debug("Replaying " + std::to_string(m_playback.speed) + " step(s)/s");
+}
+
+void Game::startPlayback(const sudoku::SolveWorker::Result &res) {
+  if (res.log->truncated()) {
+    warn("Replaying only the first " + std::to_string(res.log->size()) +
+         " step(s) of the resolution");
+  }
+
+  m_playback.log = res.log;
+  m_playback.next = 0u;
+  m_playback.credit = 0.0f;
+  m_playback.digits.fill(0u);
+  m_playback.backtracks.fill(0u);
+  m_playback.solved = res.solved;
+  m_playback.solution = res.solution;
+
+  m_state.solverStep = SolverStep::Replaying;
+}
+
+void Game::updatePlayback(float tDelta) {
+  if (m_state.solverStep != SolverStep::Replaying) {
+    // Release the steps of a replay interrupted by a change
+    // of mode.
+    m_playback.log = nullptr;
+    return;
+  }
+
+  // The replay is only relevant for the board it was
+  // recorded for.
+  if (!sameBoardAsSolve()) {
+    warn("Stopping replay, board changed");
+    m_playback.log = nullptr;
+    m_state.solverStep = SolverStep::Preparing;
+    return;
+  }
+
+  const sudoku::algorithm::StepLog &log = *m_playback.log;
+
+  m_playback.credit += m_playback.speed * tDelta;
+  std::size_t count = static_cast<std::size_t>(m_playback.credit);
+  m_playback.credit -= count;
+
+  std::size_t end = std::min(m_playback.next + count, log.size());
+  for (; m_playback.next < end; ++m_playback.next) {
+    sudoku::algorithm::StepLog::Step s = log.at(m_playback.next);
+
+    if (s.backtrack) {
+      m_playback.digits[s.cell] = 0u;
+      m_playback.backtracks[s.cell] = static_cast<std::uint8_t>(s.digit);
+    } else {
+      m_playback.digits[s.cell] = static_cast<std::uint8_t>(s.digit);
+      m_playback.backtracks[s.cell] = 0u;
+    }
+  }
+
+  if (m_playback.next >= log.size()) {
+    finishPlayback();
+  }
+}
+
+void Game::finishPlayback() {
+  m_playback.log = nullptr;
+
+  if (!m_playback.solved) {
+    m_state.solverStep = SolverStep::Unsolvable;
+    return;
+  }
+
+  m_state.solverStep = SolverStep::Solved;
+  fillSolution(m_playback.solution);
+}
+
+void Game::fillSolution(const sudoku::algorithm::Grid &solution) {
+  const sudoku::Board &b = (*m_board)();
+
+  for (unsigned y = 0u; y < 9u; ++y) {
+    for (unsigned x = 0u; x < 9u; ++x) {
+      if (b.at(x, y) == 0u) {
+        m_board->put(x, y, solution[y * 9u + x], sudoku::DigitKind::Solved);
+      }
+    }
+  }
+}
+
+bool Game::pollSolve(sudoku::SolveWorker::Result &res, bool changed) {
+  if (m_solve.worker != nullptr) {
+    return m_solve.worker->poll(res);
+  }
+
+  // Do not spend time on a search whose result will be
+  // discarded anyway.
+  if (!m_solve.pending || changed ||
+      m_state.solverStep != SolverStep::Solving) {
+    return false;
+  }
+
+  using State = sudoku::algorithm::SteppedSolver::State;
+  sudoku::algorithm::SteppedSolver &s = *m_solve.stepped;
+
+  if (s.resume(std::chrono::microseconds(SOLVE_SLICE_US)) == State::Running) {
+    return false;
+  }
+
+  res.id = m_solve.id;
+  res.cancelled = false;
+  res.solved = (s.state() == State::Solved);
+  res.solution = s.grid();
+  res.nodes = s.nodes();
+  res.duration = s.duration();
+  res.log = m_solve.log;
+
+  return true;
+}
+
+unsigned Game::exploredNodes() const noexcept {
+  if (m_solve.worker != nullptr) {
+    return m_solve.worker->nodes();
+  }
+
+  return m_solve.stepped->nodes();
+}
+
+void Game::updateGenerateStatus() {
+  // Past the timeout, ask the worker to stop removing digits:
+  // this yields a simpler puzzle instead of keeping the player
+  // waiting.
+  if (m_generate.pending && !m_generate.hurried &&
+      utils::now() >
+          m_generate.start + utils::toMilliseconds(GENERATION_TIMEOUT_MS)) {
+    m_generate.worker->hurry();
+    m_generate.hurried = true;
+  }
+
+  sudoku::GenerateWorker::Result res;
+  while (m_generate.worker->poll(res)) {
+    // Results of previous requests are not relevant.
+    if (!m_generate.pending || res.id != m_generate.id) {
+      continue;
+    }
+
+    m_generate.pending = false;
+
+    if (!res.success) {
+      warn("Failed to generate sudoku");
+    } else {
+      if (res.hurried) {
+        warn("Generation took more than " +
+                 std::to_string(GENERATION_TIMEOUT_MS) + "ms",
+             "Falling back to a simpler puzzle");
+      }
+
+      m_board->initialize(res.board);
+    }
+
+    enable(!m_state.paused);
+  }
+
+  if (m_menus.loading != nullptr) {
+    m_menus.loading->setVisible(m_generate.pending);
+  }
+}
+
 bool Game::TimedMenu::update(bool active) noexcept {
   // In case the menu should be active.
   if (active) {
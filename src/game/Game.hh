@@ -5,7 +5,12 @@
 # include <memory>
 # include <core_utils/CoreObject.hh>
 # include <core_utils/TimeUtils.hh>
+# include <core_utils/Signal.hh>
 # include "Sudoku.hh"
+# include "SaveWorker.hh"
+# include "SolveWorker.hh"
+# include "GenerateWorker.hh"
+# include "SteppedSolver.hh"
 
 namespace pge {
 
@@ -87,6 +92,15 @@ namespace pge {
       bool
       terminated() const noexcept;
 
+      /**
+       * @brief - The time spent by the last resolution requested
+       *          through `solve` to find a solution.
+       * @return - the duration in milliseconds or a negative
+       *           value if no puzzle was solved yet.
+       */
+      float
+      lastSolveDuration() const noexcept;
+
       /**
        * @brief - Forward the call to step one step ahead
        *          in time to the internal world.
@@ -162,11 +176,13 @@ namespace pge {
 
       /**
        * @brief - Save the current state of the board to a default
-       *          file with the name provided in input.
+       *          file with the name provided in input. The board
+       *          is snapshotted and written in the background: the
+       *          completion is reported through an alert.
        * @param file - the file to save the board into.
        */
       void
-      save(const std::string& file) const;
+      save(const std::string& file);
 
       /**
        * @brief - Called to notify the current highlighted cell.
@@ -188,9 +204,27 @@ namespace pge {
       void
       onDigitPressed(unsigned digit);
 
+      /**
+       * @brief - Switch between putting the digits pressed by the
+       *          user in the active cell and toggling them in the
+       *          pencil marks of the cell.
+       */
+      void
+      togglePencil() noexcept;
+
+      /**
+       * @brief - Mark all the digits which can be put in each empty
+       *          cell, or remove all the marks if they were filled
+       *          this way already.
+       */
+      void
+      toggleMarks();
+
       /**
        * @brief - Defines a new difficulty level for the game.
-       *          This will reset the current grid.
+       *          This will reset the current grid: the new one
+       *          is generated in the background and the UI is
+       *          disabled until it is available.
        * @param level - the new difficulty level.
        */
       void
@@ -198,13 +232,115 @@ namespace pge {
 
       /**
        * @brief - Attempts to solve the sudoku in its current
-       *          state.
+       *          state. The search happens in the background:
+       *          the solution is applied to the board by the
+       *          first call to `step` after it is found.
        */
       void
       solve();
 
+      /**
+       * @brief - Interrupt the resolution in progress, if any.
+       */
+      void
+      cancelSolve();
+
+      /**
+       * @brief - Whether a resolution is in progress, or being
+       *          replayed.
+       * @return - `true` if the sudoku is being solved.
+       */
+      bool
+      solving() const noexcept;
+
+      /**
+       * @brief - Whether a puzzle is being generated.
+       * @return - `true` if the board is not available yet.
+       */
+      bool
+      generating() const noexcept;
+
+      /**
+       * @brief - The digits assigned so far by the resolution in
+       *          progress. Only available when the resolution is
+       *          spread over the frames rather than performed by
+       *          a separate thread.
+       * @return - the partial assignment or `null` if it is not
+       *           available.
+       */
+      const sudoku::algorithm::Grid*
+      partialSolution() const noexcept;
+
+      /**
+       * @brief - The digits removed by the replayed search from the
+       *          cells which are still empty.
+       * @return - the digits removed or `null` if no resolution is
+       *           being replayed.
+       */
+      const sudoku::algorithm::Grid*
+      backtracks() const noexcept;
+
+      /**
+       * @brief - Toggle the recording of the steps of the next
+       *          resolutions: when enabled, the search is replayed
+       *          on the board before displaying the solution.
+       */
+      void
+      togglePlayback();
+
+      /**
+       * @brief - Multiply the number of steps replayed each second
+       *          by the input factor.
+       * @param factor - the factor to apply to the speed.
+       */
+      void
+      scalePlaybackSpeed(float factor);
+
+      /**
+       * @brief - Revert the last move performed by the player.
+       */
+      void
+      undo();
+
+      /**
+       * @brief - Apply again the last move reverted by `undo`.
+       */
+      void
+      redo();
+
+      /**
+       * @brief - Whether a game interrupted during a previous
+       *          session can be resumed with `recover`.
+       * @return - `true` if a game can be resumed.
+       */
+      bool
+      canRecover() const noexcept;
+
+      /**
+       * @brief - Rebuild the game interrupted during a previous
+       *          session from the journal of moves.
+       * @return - `true` if the game could be recovered.
+       */
+      bool
+      recover();
+
     private:
 
+      /**
+       * @brief - Attach the journal to the current board in case
+       *          the player is playing, and discard it otherwise.
+       */
+      void
+      attachJournal();
+
+      /**
+       * @brief - Request a new puzzle for the level of the board
+       *          to the generation worker. The board is cleared
+       *          and the UI disabled until the puzzle is received.
+       */
+      void
+      generate();
+
       /**
        * @brief - Used to enable or disable the menus that
        *          compose the game. This allows to easily
@@ -238,6 +374,95 @@ namespace pge {
       void
       updateUIForSolver();
 
+      /**
+       * @brief - Fetch the results of the saves performed in the
+       *          background and update the corresponding alerts.
+       */
+      void
+      updateSaveStatus();
+
+      /**
+       * @brief - Fetch the result of the resolution performed in
+       *          the background and apply it to the board if it
+       *          did not change in the meantime.
+       */
+      void
+      updateSolveStatus();
+
+      /**
+       * @brief - Whether the board is still the one for which the
+       *          last resolution was requested, in the same state.
+       * @return - `true` if the board did not change since then.
+       */
+      bool
+      sameBoardAsSolve() const noexcept;
+
+      /**
+       * @brief - Update the text of the solve buttons to display
+       *          the progress of the resolution.
+       */
+      void
+      updateSolveButtons();
+
+      /**
+       * @brief - Fetch the result of the resolution in progress. The
+       *          stepped solver is resumed for a slice of the frame
+       *          when there is no worker.
+       * @param res - output receiving the result.
+       * @param changed - whether the board changed since the start
+       *                  of the resolution.
+       * @return - `true` if a result was available.
+       */
+      bool
+      pollSolve(sudoku::SolveWorker::Result& res, bool changed);
+
+      /**
+       * @brief - The number of nodes explored by the resolution in
+       *          progress.
+       * @return - the number of nodes explored so far.
+       */
+      unsigned
+      exploredNodes() const noexcept;
+
+      /**
+       * @brief - Start replaying the steps of the resolution which
+       *          produced the input result.
+       * @param res - the result of the resolution.
+       */
+      void
+      startPlayback(const sudoku::SolveWorker::Result& res);
+
+      /**
+       * @brief - Apply the steps of the replayed search which are
+       *          due since the last frame.
+       * @param tDelta - the duration of the last frame in seconds.
+       */
+      void
+      updatePlayback(float tDelta);
+
+      /**
+       * @brief - Stop the replay and display the outcome of the
+       *          resolution.
+       */
+      void
+      finishPlayback();
+
+      /**
+       * @brief - Put the digits of the solution in the empty cells
+       *          of the board.
+       * @param solution - the solution of the puzzle.
+       */
+      void
+      fillSolution(const sudoku::algorithm::Grid& solution);
+
+      /**
+       * @brief - Fetch the puzzle generated in the background and
+       *          load it in the board. Also hurries the generation
+       *          when it takes too long.
+       */
+      void
+      updateGenerateStatus();
+
     private:
 
       /// @brief - Convenience structure allowing to group information
@@ -273,6 +498,7 @@ namespace pge {
         None,
         Preparing,
         Solving,
+        Replaying,
         Solved,
         Unsolvable,
       };
@@ -308,6 +534,13 @@ namespace pge {
 
         // Whether or not the game has been finished.
         bool done;
+
+        // Whether the digits pressed by the user are toggled in
+        // the pencil marks of the active cell.
+        bool pencil;
+
+        // Whether the pencil marks were filled automatically.
+        bool marked;
       };
 
       /// @brief - Convenience structure allowing to regroup
@@ -316,6 +549,10 @@ namespace pge {
         // The menus holding the remaining digits count to find.
         std::vector<MenuShPtr> digits;
 
+        // The count displayed by each of the `digits` menus: they
+        // are only updated when the count of the board changes.
+        std::vector<unsigned> counts;
+
         // The status menu for the digits to find.
         MenuShPtr status;
 
@@ -325,6 +562,10 @@ namespace pge {
         // The solve button for the solver mode.
         MenuShPtr solve;
 
+        // The solve button of the status menu in the interactive
+        // mode.
+        MenuShPtr quickSolve;
+
         // The back button to return to the mode selection from
         // the solver mode.
         MenuShPtr back;
@@ -335,6 +576,112 @@ namespace pge {
         // The alert menu indicating the the sudoku couldn't be
         // solved.
         TimedMenu unsolvableAlert;
+
+        // The alert menu indicating that a save completed.
+        TimedMenu savedAlert;
+
+        // The alert menu indicating that a save failed.
+        TimedMenu saveFailedAlert;
+
+        // The message box displayed while a puzzle is being
+        // generated.
+        MenuShPtr loading;
+      };
+
+      /// @brief - Convenience structure holding the information
+      /// about the saves performed in the background.
+      struct SaveData {
+        // The worker writing the saves.
+        sudoku::SaveWorkerShPtr worker;
+
+        // The results fetched from the worker: kept to avoid
+        // allocating at each frame.
+        std::vector<sudoku::SaveWorker::Result> results;
+
+        // The last time a save completed successfully.
+        utils::TimeStamp succeeded;
+
+        // The last time a save failed.
+        utils::TimeStamp failed;
+      };
+
+      /// @brief - Convenience structure holding the information
+      /// about the resolution performed in the background.
+      struct SolveData {
+        // The worker solving the puzzles, only created in case
+        // the machine has more than one core.
+        sudoku::SolveWorkerShPtr worker;
+
+        // Otherwise the solver resumed for a slice of each frame
+        // so that the rendering is not stalled.
+        std::shared_ptr<sudoku::algorithm::SteppedSolver> stepped;
+
+        // The log recording the steps of the stepped solver.
+        std::shared_ptr<sudoku::algorithm::StepLog> log;
+
+        // The identifier of the last request and whether its
+        // result is still expected.
+        unsigned long id;
+        bool pending;
+
+        // The game and the revision of its board when the
+        // resolution was requested: the solution is discarded
+        // if the board changed in the meantime. The game is not
+        // kept alive: a game replacing it once it is released
+        // can't be mistaken for it.
+        std::weak_ptr<sudoku::Game> game;
+        unsigned long revision;
+
+        // When the resolution was requested.
+        utils::TimeStamp start;
+      };
+
+      /// @brief - Convenience structure holding the information
+      /// about the replay of the steps of a resolution.
+      struct PlaybackData {
+        // Whether the steps of the resolutions are recorded to
+        // be replayed.
+        bool enabled;
+
+        // The number of steps replayed each second.
+        float speed;
+
+        // The steps being replayed, `null` when no replay is in
+        // progress.
+        std::shared_ptr<const sudoku::algorithm::StepLog> log;
+
+        // The index of the next step to replay and the fraction
+        // of step accumulated over the frames.
+        std::size_t next;
+        float credit;
+
+        // The digits put by the replayed search, and the digits
+        // it removed from the cells which are still empty.
+        sudoku::algorithm::Grid digits;
+        sudoku::algorithm::Grid backtracks;
+
+        // The outcome of the resolution, displayed at the end of
+        // the replay.
+        bool solved;
+        sudoku::algorithm::Grid solution;
+      };
+
+      /// @brief - Convenience structure holding the information
+      /// about the generation performed in the background.
+      struct GenerateData {
+        // The worker generating the puzzles.
+        sudoku::GenerateWorkerShPtr worker;
+
+        // The identifier of the last request and whether its
+        // result is still expected.
+        unsigned long id;
+        bool pending;
+
+        // When the generation was requested.
+        utils::TimeStamp start;
+
+        // Whether the worker was already asked to hurry.
+        bool hurried;
       };
 
       /// @brief - Convenience structure registering the properties
@@ -380,6 +727,51 @@ namespace pge {
        *          and the hints.
        */
       HintData m_hint;
+
+      /**
+       * @brief - The data needed to perform saves in the background
+       *          and to report their status.
+       */
+      SaveData m_save;
+
+      /**
+       * @brief - The data needed to solve the puzzle in the
+       *          background and to display its progress.
+       */
+      SolveData m_solve;
+
+      /**
+       * @brief - The data needed to generate puzzles in the
+       *          background.
+       */
+      GenerateData m_generate;
+
+      /**
+       * @brief - The data needed to replay the steps of the last
+       *          resolution.
+       */
+      PlaybackData m_playback;
+
+      /**
+       * @brief - The journal recording the moves of the player so
+       *          that they can be undone and recovered after a crash.
+       */
+      sudoku::JournalShPtr m_journal;
+
+      /**
+       * @brief - The duration of the last resolution in milliseconds
+       *          or a negative value if none happened yet.
+       */
+      float m_lastSolve;
+
+    public:
+
+      /**
+       * @brief - Signal emitted whenever a game was successfully saved
+       *          in the background. The parameter corresponds to the
+       *          path to the file that was written.
+       */
+      utils::Signal<const std::string&> onGameSaved;
   };
 
   using GameShPtr = std::shared_ptr<Game>;
@@ -25,6 +25,49 @@ namespace pge {
     return m_state.terminated;
   }
 
+  inline
+  float
+  Game::lastSolveDuration() const noexcept {
+    return m_lastSolve;
+  }
+
+  inline
+  bool
+  Game::solving() const noexcept {
+    return m_state.solverStep == SolverStep::Solving ||
+           m_state.solverStep == SolverStep::Replaying;
+  }
+
+  inline
+  bool
+  Game::generating() const noexcept {
+    return m_generate.pending;
+  }
+
+  inline
+  const sudoku::algorithm::Grid*
+  Game::partialSolution() const noexcept {
+    if (m_state.solverStep == SolverStep::Replaying) {
+      return &m_playback.digits;
+    }
+
+    if (m_solve.stepped == nullptr || !m_solve.pending) {
+      return nullptr;
+    }
+
+    return &m_solve.stepped->grid();
+  }
+
+  inline
+  const sudoku::algorithm::Grid*
+  Game::backtracks() const noexcept {
+    if (m_state.solverStep != SolverStep::Replaying) {
+      return nullptr;
+    }
+
+    return &m_playback.backtracks;
+  }
+
   inline
   void
   Game::pause() {
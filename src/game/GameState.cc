@@ -71,6 +71,7 @@ namespace pge {
     m_screen(screen == Screen::Home ? Screen::Exit : Screen::Home),
 
     m_home(nullptr),
+    m_resume(nullptr),
     m_modeSelector(nullptr),
     m_difficultySelector(nullptr),
     m_loadGame(nullptr),
@@ -96,10 +97,15 @@ namespace pge {
 
     // Connect the slot to receive updates about saved games.
     m_savedGames.onSavedGameSelected.connect_member<GameState>(this, &GameState::onSavedGamePicked);
+
+    // Keep the index of saved games up to date when a game
+    // is saved.
+    m_game.onGameSaved.connect_member<SavedGames>(&m_savedGames, &SavedGames::registerSave);
   }
 
   GameState::~GameState() {
     m_savedGames.onSavedGameSelected.disconnectAll();
+    m_game.onGameSaved.disconnectAll();
   }
 
   Screen
@@ -116,6 +122,13 @@ namespace pge {
     // Assign the state.
     m_screen = screen;
 
+    // Only propose to resume a game when one is available.
+    if (m_screen == Screen::Home) {
+      bool recoverable = m_game.canRecover();
+      m_resume->setText(recoverable ? "Resume game" : "");
+      m_resume->setEnabled(recoverable);
+    }
+
     // Update screens' visibility.
     m_home->setVisible(m_screen == Screen::Home);
     m_modeSelector->setVisible(m_screen == Screen::ModeSelector);
@@ -135,6 +148,18 @@ namespace pge {
     m_gameOver->render(pge);
   }
 
+  unsigned long
+  GameState::revision() const noexcept {
+    // Revisions only increase so their sum changes as soon as
+    // one of the screens does.
+    return m_home->revision() +
+           m_modeSelector->revision() +
+           m_difficultySelector->revision() +
+           m_loadGame->revision() +
+           m_loadGameModeSelector->revision() +
+           m_gameOver->revision();
+  }
+
   menu::InputHandle
   GameState::processUserInput(const controls::State& c,
                               std::vector<ActionShPtr>& actions)
@@ -188,6 +213,20 @@ namespace pge {
     m_home = generateDefaultScreen(dims, olc::DARK_PINK);
 
     // Add each option to the screen.
+    m_resume = generateScreenOption(dims, "", olc::VERY_DARK_PINK, "resume_game", true);
+    m_resume->setSimpleAction(
+      [this](Game& g) {
+        // Rebuild the interrupted game from its journal.
+        if (!g.recover()) {
+          return;
+        }
+
+        g.setMode(Mode::Interactive);
+        setScreen(Screen::Game);
+      }
+    );
+    m_home->addMenu(m_resume);
+
     MenuShPtr m = generateScreenOption(dims, "New game", olc::VERY_DARK_PINK, "new_game", true);
     m->setSimpleAction(
       [this](Game& /*g*/) {
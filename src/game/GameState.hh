@@ -67,6 +67,16 @@ namespace pge {
       void
       render(olc::PixelGameEngine* pge) const;
 
+      /**
+       * @brief - A counter which changes each time the screens
+       *          need to be rendered again. Changing the screen
+       *          updates the visibility of the menus so it also
+       *          modifies this counter.
+       * @return - the revision of the screens.
+       */
+      unsigned long
+      revision() const noexcept;
+
       /**
        * @brief - Performs the interpretation of the controls
        *          provided as input to update the selected
@@ -134,6 +144,13 @@ namespace pge {
        */
       MenuShPtr m_home;
 
+      /**
+       * @brief - The option of the home screen allowing to resume
+       *          a game interrupted during a previous session. It
+       *          is only enabled when such a game exists.
+       */
+      MenuShPtr m_resume;
+
       /**
        * @brief - Defines the screen to display when the game is
        *          on the mode selector screen.
@@ -0,0 +1,63 @@
+
+#include "GenerateWorker.hh"
+
+namespace sudoku {
+namespace {
+
+/// @brief - The number of times the generation of a puzzle is
+/// attempted before reporting a failure.
+constexpr unsigned attempts = 3u;
+
+} // namespace
+
+GenerateWorker::GenerateWorker()
+    : RequestWorker("generator", Policy::Latest),
+
+      m_hurry(false), m_rng() {
+  start();
+}
+
+GenerateWorker::~GenerateWorker() { stop(); }
+
+unsigned long GenerateWorker::generate(const Level &level) {
+  return submit(level);
+}
+
+void GenerateWorker::hurry() noexcept {
+  m_hurry.store(true, std::memory_order_relaxed);
+}
+
+GenerateWorker::Result GenerateWorker::process(unsigned long id,
+                                               const Level &level) {
+  Result res{id, false, false, PackedBoard()};
+
+  // The generator relies on a greedy solver which can
+  // fail on some seeds: try again in this case.
+  for (unsigned attempt = 0u; attempt < attempts && !res.success; ++attempt) {
+    Board board;
+    withSafetyNet(
+        [&board, &res, level, this]() {
+          res.success = board.generate(toClues(level), m_rng, &m_hurry);
+        },
+        "Board::generate");
+
+    if (res.success) {
+      res.board = board.pack();
+    }
+  }
+
+  res.hurried = m_hurry.load(std::memory_order_relaxed);
+
+  return res;
+}
+
+void GenerateWorker::interrupt() noexcept {
+  // The generation in progress is not relevant anymore.
+  m_hurry.store(true, std::memory_order_relaxed);
+}
+
+void GenerateWorker::prepare() noexcept {
+  m_hurry.store(false, std::memory_order_relaxed);
+}
+
+} // namespace sudoku
@@ -0,0 +1,91 @@
+#ifndef GENERATE_WORKER_HH
+#define GENERATE_WORKER_HH
+
+#include "Board.hh"
+#include "PackedBoard.hh"
+#include "RequestWorker.hh"
+#include <atomic>
+#include <core_utils/RNG.hh>
+#include <memory>
+
+namespace sudoku {
+
+/// @brief - The outcome of a request to generate a puzzle.
+struct GenerateResult {
+  // The identifier of the request, as returned by `generate`.
+  unsigned long id;
+
+  // Whether a puzzle could be generated.
+  bool success;
+
+  // Whether the generation was hurried, in which case the
+  // puzzle has more digits than expected for its level.
+  bool hurried;
+
+  // The generated puzzle.
+  PackedBoard board;
+};
+
+/// @brief - Generates puzzles on a dedicated thread so that the
+/// caller stays responsive. A single puzzle is generated at a time
+/// and a new request replaces the one waiting to be processed. The
+/// generation can be hurried: it then stops removing digits and
+/// produces a simpler puzzle. The results are handed back through
+/// a lock-free queue.
+class GenerateWorker : public RequestWorker<Level, GenerateResult, 4u> {
+public:
+  /// @brief - The outcome of a request.
+  using Result = GenerateResult;
+
+  /**
+   * @brief - Create a new worker and start its thread.
+   */
+  GenerateWorker();
+
+  /**
+   * @brief - Hurry the generation in progress and stop the thread.
+   */
+  ~GenerateWorker() override;
+
+  /**
+   * @brief - Register a request to generate a puzzle for the input
+   *          level. This method returns right away and the result
+   *          can be fetched with `poll`.
+   * @param level - the difficulty level of the puzzle.
+   * @return - the identifier of the request.
+   */
+  unsigned long generate(const Level &level);
+
+  /**
+   * @brief - Stop removing digits from the puzzle being generated:
+   *          it is reported as soon as possible, with the digits
+   *          which were not removed yet. A request not picked up
+   *          by the worker yet is not affected.
+   */
+  void hurry() noexcept;
+
+protected:
+  Result process(unsigned long id, const Level &level) override;
+
+  void interrupt() noexcept override;
+
+  void prepare() noexcept override;
+
+private:
+  /**
+   * @brief - Set to stop removing digits from the puzzle being
+   *          generated.
+   */
+  std::atomic<bool> m_hurry;
+
+  /**
+   * @brief - The random number generator used by the generation,
+   *          only accessed by the worker thread.
+   */
+  utils::RNG m_rng;
+};
+
+using GenerateWorkerShPtr = std::shared_ptr<GenerateWorker>;
+} // namespace sudoku
+
+#endif /* GENERATE_WORKER_HH */
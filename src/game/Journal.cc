@@ -0,0 +1,306 @@
+
+#include "Journal.hh"
+#include "FileSync.hh"
+#include <cstring>
+#include <filesystem>
+
+namespace sudoku {
+namespace {
+
+/// @brief - The magic bytes identifying a journal file, followed
+/// by the version of the format and some reserved bytes.
+constexpr char header[] = {'S', 'D', 'K', 'J', 1, 0, 0, 0};
+
+/// @brief - The size of a single record in the journal file.
+constexpr unsigned recordSize = 3u;
+
+/// @brief - The number of records written together to the file.
+constexpr unsigned batchRecords = 32u;
+
+/// @brief - The maximum delay in milliseconds before a pending
+/// record is written to the file.
+constexpr int flushDelayMs = 1000;
+
+/// @brief - The number of records after which the file should be
+/// rewritten from a new snapshot.
+constexpr unsigned compactThreshold = 1024u;
+
+/// @brief - Read the header of the journal and returns whether it
+/// is valid.
+bool readHeader(std::istream &in) {
+  char buf[sizeof(header)];
+  in.read(buf, sizeof(buf));
+
+  return in.good() && std::memcmp(buf, header, sizeof(header)) == 0;
+}
+
+} // namespace
+
+Journal::Journal(const std::string &file)
+    : utils::CoreObject("journal"),
+
+      m_file(file), m_out(), m_recoverable(false), m_pending(),
+      m_lastFlush(utils::now()), m_records(0u), m_history(), m_first(0u),
+      m_size(0u), m_cursor(0u) {
+  setService("sudoku");
+
+  m_pending.reserve(batchRecords * recordSize);
+
+  std::ifstream in(m_file, std::ios::binary);
+  PackedBoard board;
+  m_recoverable = in.good() && readHeader(in) && board.load(in);
+}
+
+Journal::~Journal() { flush(true); }
+
+bool Journal::recoverable() const noexcept { return m_recoverable; }
+
+void Journal::start(const PackedBoard &board, const SaveMetadata &metadata) {
+  m_first = 0u;
+  m_size = 0u;
+  m_cursor = 0u;
+
+  rewrite(board, metadata);
+}
+
+bool Journal::compactable() const noexcept {
+  return m_records >= compactThreshold;
+}
+
+void Journal::compact(const PackedBoard &board, const SaveMetadata &metadata) {
+  debug("Compacting journal after " + std::to_string(m_records) + " record(s)");
+  rewrite(board, metadata);
+}
+
+void Journal::record(const Move &move) {
+  push(move);
+  append(Type::Do, move);
+}
+
+bool Journal::undo(Move &move) {
+  if (m_cursor == 0u) {
+    return false;
+  }
+
+  --m_cursor;
+  move = m_history[(m_first + m_cursor) % historySize];
+  append(Type::Undo, move);
+
+  return true;
+}
+
+bool Journal::redo(Move &move) {
+  if (m_cursor == m_size) {
+    return false;
+  }
+
+  move = m_history[(m_first + m_cursor) % historySize];
+  ++m_cursor;
+  append(Type::Redo, move);
+
+  return true;
+}
+
+void Journal::flush(bool force) {
+  if (m_pending.empty()) {
+    return;
+  }
+
+  utils::TimeStamp now = utils::now();
+  if (!force && m_pending.size() < batchRecords * recordSize &&
+      now < m_lastFlush + utils::toMilliseconds(flushDelayMs)) {
+    return;
+  }
+
+  m_out.write(m_pending.data(), m_pending.size());
+  m_out.flush();
+
+  if (!m_out.good()) {
+    warn("Failed to write journal \"" + m_file + "\"",
+         "Disabling journal for the current session");
+    m_out.close();
+  }
+
+  m_pending.clear();
+  m_lastFlush = now;
+}
+
+void Journal::discard() {
+  m_out.close();
+  m_pending.clear();
+  m_records = 0u;
+
+  m_first = 0u;
+  m_size = 0u;
+  m_cursor = 0u;
+
+  std::error_code err;
+  std::filesystem::remove(m_file, err);
+  m_recoverable = false;
+}
+
+bool Journal::recover(PackedBoard &board, SaveMetadata &metadata) {
+  flush(true);
+  m_out.close();
+
+  m_first = 0u;
+  m_size = 0u;
+  m_cursor = 0u;
+  m_records = 0u;
+
+  std::ifstream in(m_file, std::ios::binary);
+  if (!in.good() || !readHeader(in) || !board.load(in, &metadata)) {
+    warn("Failed to recover session from \"" + m_file + "\"");
+    m_recoverable = false;
+    return false;
+  }
+
+  // Replay the records onto the snapshot. Any trailing data
+  // that is not a valid record (typically a partial write in
+  // case of a crash) is dropped.
+  std::uintmax_t valid = static_cast<std::uintmax_t>(in.tellg());
+
+  char buf[recordSize];
+  while (in.read(buf, recordSize)) {
+    Move m;
+    m.cell = static_cast<std::uint8_t>(buf[0]);
+    m.oldDigit = static_cast<std::uint8_t>(buf[1]) & 0xFu;
+    m.newDigit = static_cast<std::uint8_t>(buf[1]) >> 4u;
+    m.oldKind = static_cast<DigitKind>(buf[2] & 0x3);
+    m.newKind = static_cast<DigitKind>((buf[2] >> 2) & 0x3);
+    unsigned type = (static_cast<std::uint8_t>(buf[2]) >> 4u) & 0x3u;
+
+    if (m.cell >= counting::cellsCount || m.oldDigit > 9u ||
+        m.newDigit > 9u || type > static_cast<unsigned>(Type::Redo)) {
+      break;
+    }
+
+    switch (static_cast<Type>(type)) {
+    case Type::Undo:
+      board.set(m.cell, m.oldDigit, m.oldKind);
+      m_cursor = (m_cursor > 0u ? m_cursor - 1u : 0u);
+      break;
+    case Type::Redo:
+      board.set(m.cell, m.newDigit, m.newKind);
+      m_cursor = (m_cursor < m_size ? m_cursor + 1u : m_size);
+      break;
+    case Type::Do:
+    default:
+      board.set(m.cell, m.newDigit, m.newKind);
+      push(m);
+      break;
+    }
+
+    ++m_records;
+    valid += recordSize;
+  }
+
+  in.close();
+
+  std::error_code err;
+  if (std::filesystem::file_size(m_file, err) != valid && !err) {
+    warn("Dropping invalid data at the end of journal \"" + m_file + "\"");
+    std::filesystem::resize_file(m_file, valid, err);
+  }
+
+  m_out.open(m_file, std::ios::binary | std::ios::app);
+  m_lastFlush = utils::now();
+  m_recoverable = true;
+
+  info("Recovered session with " + std::to_string(m_records) +
+       " move(s) from \"" + m_file + "\"");
+
+  return true;
+}
+
+void Journal::append(const Type &type, const Move &move) {
+  if (!m_out.is_open()) {
+    return;
+  }
+
+  m_pending.push_back(static_cast<char>(move.cell));
+  m_pending.push_back(
+      static_cast<char>((move.oldDigit & 0xFu) | ((move.newDigit & 0xFu) << 4u)));
+  m_pending.push_back(static_cast<char>(
+      (static_cast<unsigned>(move.oldKind) & 0x3u) |
+      ((static_cast<unsigned>(move.newKind) & 0x3u) << 2u) |
+      (static_cast<unsigned>(type) << 4u)));
+
+  ++m_records;
+
+  flush();
+}
+
+void Journal::push(const Move &move) noexcept {
+  // Moves that were undone can't be redone anymore.
+  m_size = m_cursor;
+
+  if (m_size == historySize) {
+    m_first = (m_first + 1u) % historySize;
+    --m_size;
+  }
+
+  m_history[(m_first + m_size) % historySize] = move;
+  ++m_size;
+  m_cursor = m_size;
+}
+
+void Journal::rewrite(const PackedBoard &board, const SaveMetadata &metadata) {
+  m_out.close();
+  m_pending.clear();
+  m_records = 0u;
+
+  // Write the snapshot to a temporary file first so that the
+  // previous session is still available in case of a crash.
+  std::string tmp = m_file + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(header, sizeof(header));
+    board.save(out, metadata);
+
+    out.close();
+
+    if (out.fail()) {
+      warn("Failed to write journal \"" + m_file + "\"",
+           "Failed to write \"" + tmp + "\"");
+      std::error_code ignored;
+      std::filesystem::remove(tmp, ignored);
+      m_recoverable = false;
+      return;
+    }
+  }
+
+  // Flush the snapshot before the rename and the directory after
+  // it: otherwise a crash could replace the previous journal with
+  // an empty one.
+  std::string reason = syncFile(tmp);
+  if (!reason.empty()) {
+    warn("Failed to write journal \"" + m_file + "\"",
+         "Failed to flush \"" + tmp + "\": " + reason);
+    std::error_code ignored;
+    std::filesystem::remove(tmp, ignored);
+    m_recoverable = false;
+    return;
+  }
+
+  std::error_code err;
+  std::filesystem::rename(tmp, m_file, err);
+  if (err) {
+    warn("Failed to write journal \"" + m_file + "\"", err.message());
+    std::filesystem::remove(tmp, err);
+    m_recoverable = false;
+    return;
+  }
+
+  reason = syncParentDirectory(m_file);
+  if (!reason.empty()) {
+    warn("Failed to flush the directory of journal \"" + m_file + "\"",
+         reason);
+  }
+
+  m_out.open(m_file, std::ios::binary | std::ios::app);
+  m_lastFlush = utils::now();
+  m_recoverable = m_out.good();
+}
+
+} // namespace sudoku
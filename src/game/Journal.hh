@@ -0,0 +1,221 @@
+#ifndef JOURNAL_HH
+#define JOURNAL_HH
+
+#include "PackedBoard.hh"
+#include <array>
+#include <core_utils/CoreObject.hh>
+#include <core_utils/TimeUtils.hh>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sudoku {
+
+/// @brief - Records the moves performed on a board in an append-only
+/// file so that a session can be rebuilt after a crash. The file
+/// starts with a snapshot of the board followed by a compact record
+/// per move. Records are buffered and written in batches. The most
+/// recent moves are also kept in a fixed-size ring in memory which
+/// provides constant time undo and redo.
+class Journal : public utils::CoreObject {
+public:
+  /// @brief - Describes a single change of a cell of the board.
+  struct Move {
+    // The linear index of the cell.
+    unsigned cell;
+
+    // The digit in the cell before the move.
+    unsigned oldDigit;
+
+    // The kind of the digit before the move.
+    DigitKind oldKind;
+
+    // The digit in the cell after the move.
+    unsigned newDigit;
+
+    // The kind of the digit after the move.
+    DigitKind newKind;
+  };
+
+  /**
+   * @brief - Create a new journal writing to the specified file.
+   *          Nothing is written until `start` is called.
+   * @param file - the path to the journal file.
+   */
+  Journal(const std::string &file);
+
+  /**
+   * @brief - Write the pending records to the disk.
+   */
+  ~Journal();
+
+  /**
+   * @brief - Whether the journal file contains a session which
+   *          can be rebuilt with `recover`.
+   * @return - `true` if a session can be recovered.
+   */
+  bool recoverable() const noexcept;
+
+  /**
+   * @brief - Start a new session from the input snapshot: any
+   *          previous content of the file and the undo history
+   *          are discarded.
+   * @param board - the snapshot of the board.
+   * @param metadata - the metadata describing the game.
+   */
+  void start(const PackedBoard &board, const SaveMetadata &metadata);
+
+  /**
+   * @brief - Whether enough records were appended since the last
+   *          snapshot to justify rewriting the file with `compact`.
+   * @return - `true` if the journal should be compacted.
+   */
+  bool compactable() const noexcept;
+
+  /**
+   * @brief - Rewrite the file with the input snapshot, dropping
+   *          the records which are now part of it. Unlike `start`
+   *          the undo history is kept.
+   * @param board - the snapshot of the board.
+   * @param metadata - the metadata describing the game.
+   */
+  void compact(const PackedBoard &board, const SaveMetadata &metadata);
+
+  /**
+   * @brief - Register a new move performed on the board. This
+   *          drops the moves which could be redone.
+   * @param move - the move to record.
+   */
+  void record(const Move &move);
+
+  /**
+   * @brief - Fetch the last move performed on the board so that
+   *          it can be reverted.
+   * @param move - output argument receiving the move to revert.
+   * @return - `false` if there's no move to undo.
+   */
+  bool undo(Move &move);
+
+  /**
+   * @brief - Fetch the last move undone so that it can be applied
+   *          again.
+   * @param move - output argument receiving the move to apply.
+   * @return - `false` if there's no move to redo.
+   */
+  bool redo(Move &move);
+
+  /**
+   * @brief - Write the pending records to the disk. Unless forced
+   *          this only happens when a full batch is available or
+   *          when records were waiting for too long.
+   * @param force - `true` to write the records right away.
+   */
+  void flush(bool force = false);
+
+  /**
+   * @brief - Stop recording and remove the journal file: used
+   *          when the session does not need to be recovered.
+   */
+  void discard();
+
+  /**
+   * @brief - Rebuild the session saved in the journal file: the
+   *          records are replayed onto the snapshot and the undo
+   *          history is restored. New records are appended after
+   *          the valid part of the file.
+   * @param board - output argument receiving the board.
+   * @param metadata - output argument receiving the metadata of
+   *                   the game.
+   * @return - `true` if the session could be recovered.
+   */
+  bool recover(PackedBoard &board, SaveMetadata &metadata);
+
+private:
+  /// @brief - The type of a record in the journal file.
+  enum class Type { Do, Undo, Redo };
+
+  /// @brief - The maximum number of moves that can be undone.
+  static constexpr unsigned historySize = 256u;
+
+  /**
+   * @brief - Append the record for the input move to the pending
+   *          data and flush if needed.
+   * @param type - the type of record.
+   * @param move - the move to record.
+   */
+  void append(const Type &type, const Move &move);
+
+  /**
+   * @brief - Push a move on the undo history, dropping the moves
+   *          which could be redone and the oldest one in case the
+   *          history is full.
+   * @param move - the move to push.
+   */
+  void push(const Move &move) noexcept;
+
+  /**
+   * @brief - Rewrite the journal file with the input snapshot.
+   * @param board - the snapshot of the board.
+   * @param metadata - the metadata describing the game.
+   */
+  void rewrite(const PackedBoard &board, const SaveMetadata &metadata);
+
+private:
+  /**
+   * @brief - The path to the journal file.
+   */
+  std::string m_file;
+
+  /**
+   * @brief - The stream used to append records to the file. Not
+   *          open when the journal is not recording.
+   */
+  std::ofstream m_out;
+
+  /**
+   * @brief - Whether the file contains a valid session.
+   */
+  bool m_recoverable;
+
+  /**
+   * @brief - The encoded records not yet written to the file.
+   */
+  std::vector<char> m_pending;
+
+  /**
+   * @brief - The last time the pending records were written.
+   */
+  utils::TimeStamp m_lastFlush;
+
+  /**
+   * @brief - The number of records written since the snapshot.
+   */
+  unsigned m_records;
+
+  /**
+   * @brief - The ring of moves available for undo and redo.
+   */
+  std::array<Move, historySize> m_history;
+
+  /**
+   * @brief - The index of the oldest move in the ring.
+   */
+  unsigned m_first;
+
+  /**
+   * @brief - The number of moves in the ring.
+   */
+  unsigned m_size;
+
+  /**
+   * @brief - The number of moves that can be undone: the moves
+   *          after this one in the ring can be redone.
+   */
+  unsigned m_cursor;
+};
+
+using JournalShPtr = std::shared_ptr<Journal>;
+} // namespace sudoku
+
+#endif /* JOURNAL_HH */
@@ -0,0 +1,241 @@
+#ifndef REQUEST_WORKER_HH
+#define REQUEST_WORKER_HH
+
+#include "SpscQueue.hh"
+#include "Trace.hh"
+#include <condition_variable>
+#include <core_utils/CoreObject.hh>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace sudoku {
+
+/// @brief - Processes requests on a dedicated thread so that the
+/// caller stays responsive, one at a time, and hands the results
+/// back through a lock-free queue. The processing of a request is
+/// provided by the inheriting class through `process`.
+///
+/// The thread calls the virtual methods of the inheriting class: it
+/// must be started with `start` at the end of its constructor and
+/// stopped with `stop` at the beginning of its destructor.
+template <typename Request, typename Result, std::size_t Capacity>
+class RequestWorker : public utils::CoreObject {
+public:
+  /// @brief - How the requests waiting to be processed are handled.
+  enum class Policy {
+    // Only the most recent request is relevant: it replaces the
+    // one waiting to be processed and interrupts the one being
+    // processed. Pending requests are dropped when stopping.
+    Latest,
+
+    // All requests are processed in order, including the ones
+    // still pending when stopping.
+    All,
+  };
+
+  /**
+   * @brief - Create a new worker. Its thread is not started yet.
+   * @param service - the name of the service, also used to name
+   *                  the thread.
+   * @param policy - how the pending requests are handled.
+   */
+  RequestWorker(const std::string &service, const Policy &policy)
+      : utils::CoreObject("worker"),
+
+        m_name(service), m_locker(), m_waiter(), m_policy(policy),
+        m_running(false), m_pending(), m_id(0u), m_results(), m_thread() {
+    setService(service);
+  }
+
+  /**
+   * @brief - Stop the thread if the inheriting class did not do it.
+   */
+  ~RequestWorker() override { stop(); }
+
+  /**
+   * @brief - Fetch the oldest result not yet fetched. Must always
+   *          be called from the same thread.
+   * @param result - output receiving the result.
+   * @return - `true` if a result was available.
+   */
+  bool poll(Result &result) noexcept { return m_results.pop(result); }
+
+protected:
+  /**
+   * @brief - Start the worker thread.
+   */
+  void start() {
+    const std::lock_guard<std::mutex> guard(m_locker);
+    if (m_running || m_thread.joinable()) {
+      return;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&RequestWorker::run, this);
+  }
+
+  /**
+   * @brief - Stop the worker thread and wait for it to finish,
+   *          according to the policy.
+   */
+  void stop() {
+    {
+      const std::lock_guard<std::mutex> guard(m_locker);
+      m_running = false;
+
+      if (m_policy == Policy::Latest) {
+        m_pending.clear();
+        interrupt();
+      }
+    }
+
+    m_waiter.notify_all();
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  /**
+   * @brief - Register a new request. This method returns right away
+   *          and the result can be fetched with `poll`.
+   * @param request - the request to process.
+   * @return - the identifier of the request.
+   */
+  unsigned long submit(const Request &request) {
+    unsigned long id;
+
+    {
+      const std::lock_guard<std::mutex> guard(m_locker);
+      id = ++m_id;
+
+      // The request in progress is not relevant anymore.
+      if (m_policy == Policy::Latest) {
+        m_pending.clear();
+        interrupt();
+      }
+
+      m_pending.emplace_back(id, request);
+    }
+
+    m_waiter.notify_one();
+
+    return id;
+  }
+
+  /**
+   * @brief - Drop the pending requests and interrupt the one being
+   *          processed, if any.
+   */
+  void cancel() {
+    const std::lock_guard<std::mutex> guard(m_locker);
+    m_pending.clear();
+    interrupt();
+  }
+
+  /**
+   * @brief - Process a request. Called from the worker thread
+   *          without holding the lock.
+   * @param id - the identifier of the request.
+   * @param request - the request to process.
+   * @return - the result of the request.
+   */
+  virtual Result process(unsigned long id, const Request &request) = 0;
+
+  /**
+   * @brief - Interrupt the request being processed, if any. Called
+   *          with the lock held.
+   */
+  virtual void interrupt() noexcept {}
+
+  /**
+   * @brief - Prepare the processing of a request, typically to
+   *          reset what `interrupt` modified. Called from the
+   *          worker thread with the lock held.
+   */
+  virtual void prepare() noexcept {}
+
+private:
+  /**
+   * @brief - The main loop of the worker thread.
+   */
+  void run() {
+    trace::setThreadName(m_name);
+
+    std::unique_lock<std::mutex> lock(m_locker);
+
+    while (m_running || !m_pending.empty()) {
+      m_waiter.wait(lock,
+                    [this]() { return !m_running || !m_pending.empty(); });
+      if (m_pending.empty()) {
+        break;
+      }
+
+      std::pair<unsigned long, Request> request = std::move(m_pending.front());
+      m_pending.pop_front();
+      prepare();
+
+      // Release the lock while processing so that new requests
+      // can be registered.
+      lock.unlock();
+
+      Result res = process(request.first, request.second);
+      if (!m_results.push(res)) {
+        warn("Dropping result of request " + std::to_string(request.first),
+             "Too many results not fetched");
+      }
+
+      lock.lock();
+    }
+  }
+
+private:
+  /**
+   * @brief - The name of the worker thread.
+   */
+  std::string m_name;
+
+  /**
+   * @brief - Protects the requests shared with the worker thread.
+   */
+  std::mutex m_locker;
+
+  /**
+   * @brief - Used to wake up the worker thread when a request is
+   *          available or when it should stop.
+   */
+  std::condition_variable m_waiter;
+
+  /**
+   * @brief - How the pending requests are handled.
+   */
+  Policy m_policy;
+
+  /**
+   * @brief - Whether the worker thread should keep running.
+   */
+  bool m_running;
+
+  /**
+   * @brief - The requests waiting to be processed along with their
+   *          identifier, and the identifier of the last request.
+   */
+  std::deque<std::pair<unsigned long, Request>> m_pending;
+  unsigned long m_id;
+
+  /**
+   * @brief - The results not yet fetched by the caller.
+   */
+  SpscQueue<Result, Capacity> m_results;
+
+  /**
+   * @brief - The thread processing the requests.
+   */
+  std::thread m_thread;
+};
+
+} // namespace sudoku
+
+#endif /* REQUEST_WORKER_HH */
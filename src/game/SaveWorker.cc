@@ -0,0 +1,107 @@
+
+#include "SaveWorker.hh"
+#include "Board.hh"
+#include "FileSync.hh"
+#include "Metrics.hh"
+#include "Trace.hh"
+#include <filesystem>
+#include <fstream>
+
+namespace sudoku {
+namespace {
+
+metrics::Counter &saveFailures() {
+  static metrics::Counter &counter = metrics::registry().counter(
+      "sudoku_save_failures_total", "Number of games which failed to save");
+  return counter;
+}
+
+} // namespace
+
+SaveWorker::SaveWorker() : RequestWorker("saves", Policy::All) { start(); }
+
+SaveWorker::~SaveWorker() { stop(); }
+
+void SaveWorker::save(const std::string &file, const PackedBoard &board,
+                      const SaveMetadata &metadata) {
+  submit(SaveRequest{file, board, metadata});
+}
+
+bool SaveWorker::poll(std::vector<Result> &results) {
+  results.clear();
+
+  Result res;
+  while (RequestWorker::poll(res)) {
+    results.push_back(res);
+  }
+
+  return !results.empty();
+}
+
+SaveWorker::Result SaveWorker::process(unsigned long /*id*/,
+                                       const SaveRequest &request) {
+  bool success = write(request);
+  if (!success) {
+    saveFailures().increment();
+  }
+
+  return Result{request.file, success};
+}
+
+bool SaveWorker::write(const SaveRequest &request) const {
+  trace::Scope scope("save", "io");
+  metrics::Timer timer(saveDuration());
+
+  std::string tmp = request.file + ".tmp";
+
+  // Whatever the failure, the temporary file should not be left
+  // behind: it would otherwise accumulate next to the saves.
+  auto fail = [this, &request, &tmp](const std::string &reason) {
+    warn("Failed to save board to \"" + request.file + "\"", reason);
+
+    std::error_code ignored;
+    std::filesystem::remove(tmp, ignored);
+
+    return false;
+  };
+
+  {
+    std::ofstream out(tmp.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.good()) {
+      return fail("Failed to open \"" + tmp + "\"");
+    }
+
+    request.board.save(out, request.metadata);
+    out.close();
+
+    if (out.fail()) {
+      return fail("Failed to write \"" + tmp + "\"");
+    }
+  }
+
+  std::string reason = syncFile(tmp);
+  if (!reason.empty()) {
+    return fail("Failed to flush \"" + tmp + "\": " + reason);
+  }
+
+  // The rename is atomic: readers either see the previous
+  // version of the file or the complete new one.
+  std::error_code err;
+  std::filesystem::rename(tmp, request.file, err);
+  if (err) {
+    return fail(err.message());
+  }
+
+  // The rename itself only survives a crash once the directory
+  // is flushed as well.
+  reason = syncParentDirectory(request.file);
+  if (!reason.empty()) {
+    return fail("Failed to flush the directory of the save: " + reason);
+  }
+
+  info("Saved board to \"" + request.file + "\"");
+
+  return true;
+}
+
+} // namespace sudoku
@@ -0,0 +1,85 @@
+#ifndef SAVE_WORKER_HH
+#define SAVE_WORKER_HH
+
+#include "PackedBoard.hh"
+#include "RequestWorker.hh"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sudoku {
+
+/// @brief - A request to save a snapshot of a board.
+struct SaveRequest {
+  std::string file;
+  PackedBoard board;
+  SaveMetadata metadata;
+};
+
+/// @brief - The outcome of a save request.
+struct SaveResult {
+  // The file that was written.
+  std::string file;
+
+  // Whether or not the file could be written.
+  bool success;
+};
+
+/// @brief - Handles the writing of saved games on a dedicated
+/// thread so that slow file systems never stall the caller. The
+/// boards are provided as snapshots and written atomically: the
+/// data first goes to a temporary file which is then renamed to
+/// its final name. All the requests are written, including the
+/// ones still pending when the worker is destroyed.
+class SaveWorker : public RequestWorker<SaveRequest, SaveResult, 64u> {
+public:
+  /// @brief - The outcome of a save request.
+  using Result = SaveResult;
+
+  /**
+   * @brief - Create a new worker and start its thread.
+   */
+  SaveWorker();
+
+  /**
+   * @brief - Write all the pending requests and stop the thread.
+   */
+  ~SaveWorker() override;
+
+  /**
+   * @brief - Register a new request to save the input snapshot
+   *          to the specified file. This method returns right
+   *          away and the result can be fetched with `poll`.
+   * @param file - the file to save the board to.
+   * @param board - the snapshot of the board to save.
+   * @param metadata - the metadata to save with the board.
+   */
+  void save(const std::string &file, const PackedBoard &board,
+            const SaveMetadata &metadata);
+
+  /**
+   * @brief - Fetch the results of the requests processed since
+   *          the last call to this method. Must always be called
+   *          from the same thread.
+   * @param results - output vector receiving the results. It is
+   *                  cleared before being filled.
+   * @return - `true` if at least one result is available.
+   */
+  bool poll(std::vector<Result> &results);
+
+protected:
+  Result process(unsigned long id, const SaveRequest &request) override;
+
+private:
+  /**
+   * @brief - Perform the atomic writing of the input request.
+   * @param request - the request to process.
+   * @return - `true` if the file could be written.
+   */
+  bool write(const SaveRequest &request) const;
+};
+
+using SaveWorkerShPtr = std::shared_ptr<SaveWorker>;
+} // namespace sudoku
+
+#endif /* SAVE_WORKER_HH */
@@ -1,6 +1,10 @@
 
 # include "SavedGames.hh"
 # include <filesystem>
+# include <fstream>
+# include <sstream>
+# include <ctime>
+# include "Definitions.hh"
 
 namespace {
 
@@ -31,6 +35,9 @@ namespace {
     return m;
   }
 
+  /// @brief - The version of the format of the index file.
+  constexpr auto indexVersion = "v3";
+
 }
 
 namespace pge {
@@ -46,6 +53,10 @@ namespace pge {
 
     m_dir(dir),
     m_ext(ext),
+    m_indexFile(dir + ".index"),
+    m_indexed(false),
+    m_dirty(false),
+    m_time(),
 
     m_saves(),
     m_index(0u),
@@ -61,6 +72,12 @@ namespace pge {
     setService("saves");
   }
 
+  SavedGames::~SavedGames() {
+    if (m_dirty) {
+      saveIndex();
+    }
+  }
+
   void
   SavedGames::generate(MenuShPtr menu) {
     olc::vi2d dims;
@@ -83,11 +100,16 @@ namespace pge {
     for (unsigned id = 0u ; id < m_gamesPerPage ; ++id) {
       MenuShPtr m = generateGameEntry("", olc::DARK_CORNFLOWER_BLUE, olc::GREY, olc::BLACK, "game" + std::to_string(id));
       m->setSimpleAction(
-        [this, m](Game& /*g*/) {
+        [this, id](Game& /*g*/) {
           // Concatenate the save directory path to the name
           // of the game so that we can readily path it to
           // other processes.
-          std::string fullPath = m_dir + "/" + m->getText() + "." + m_ext;
+          unsigned entry = m_index + id;
+          if (entry >= m_saves.size()) {
+            return;
+          }
+
+          std::string fullPath = m_dir + "/" + m_saves[entry].name + "." + m_ext;
           onSavedGameSelected.safeEmit("saved game selected", fullPath);
         }
       );
@@ -121,14 +143,101 @@ namespace pge {
 
   void
   SavedGames::refresh() {
-    // Refresh the list of games that can be loaded by
-    // re-reading the content of the save directory.
+    // Refresh the list of games that can be loaded. We
+    // first try to use the index from a previous session
+    // and only scan the directory in case its content has
+    // changed since the index was built.
     // Note that we do not update the displayed values
     // within this method.
+    FileTime time;
+    bool valid = directoryTime(time);
+
+    if (!m_indexed) {
+      m_indexed = loadIndex();
+    }
+
+    if (!m_indexed || !valid || time != m_time) {
+      scan();
+
+      m_indexed = valid;
+      m_time = time;
+      m_dirty = valid;
+    }
+
+    if (m_dirty) {
+      saveIndex();
+      m_dirty = false;
+    }
+
+    // Reset the index.
+    m_index = 0u;
+
+    // Update the display.
+    update();
+  }
+
+  void
+  SavedGames::registerSave(const std::string& file) {
+    // Only consider files in the directory and with the
+    // expected extension.
+    std::string prefix = m_dir + "/";
+    std::string suffix = "." + m_ext;
+
+    if (file.size() <= prefix.size() + suffix.size() ||
+        file.compare(0u, prefix.size(), prefix) != 0 ||
+        file.compare(file.size() - suffix.size(), suffix.size(), suffix) != 0)
+    {
+      warn("Ignoring saved game \"" + file + "\" not in \"" + m_dir + "\"");
+      return;
+    }
+
+    std::string name = file.substr(prefix.size(), file.size() - prefix.size() - suffix.size());
+
+    // Keep the list sorted: this avoids having to sort all
+    // the saves again. The metadata will be fetched when the
+    // entry is displayed.
+    std::error_code err;
+    FileTime time = std::filesystem::last_write_time(file, err);
+    Entry e{name, false, err ? FileTime() : time, sudoku::SaveMetadata()};
+
+    auto it = std::lower_bound(m_saves.begin(), m_saves.end(), e, compareEntries);
+    if (it == m_saves.end() || it->name != name) {
+      m_saves.insert(it, e);
+    } else {
+      *it = e;
+    }
+
+    registerName(name);
+
+    // The modification time of the directory is not updated:
+    // other changes might have happened since the last scan
+    // and the next refresh should detect them. The rescan is
+    // cheap as the metadata of unchanged saves is kept.
+  }
+
+  std::string
+  SavedGames::generateNewName() const noexcept {
+    // Loop until we find a file name which does not
+    // exist yet in the directory.
+    std::string out = m_dir + "/save_" + std::to_string(m_fileIndex) + "." + m_ext;
+
+    while (m_existingFiles.count(out) > 0) {
+      ++m_fileIndex;
+      out = m_dir + "/save_" + std::to_string(m_fileIndex) + "." + m_ext;
+    }
+
+    m_existingFiles.insert(out);
+
+    return out;
+  }
+
+  void
+  SavedGames::scan() {
     DirIt end;
     DirIt it(m_dir);
 
-    m_saves.clear();
+    Entries previous;
+    std::swap(previous, m_saves);
     m_existingFiles.clear();
 
     debug("Scanning directory \"" + m_dir + "\" for saved games");
@@ -142,54 +251,243 @@ namespace pge {
       std::string path = sg.path();
       std::string name = path.substr(m_dir.size() + 1u);
 
-      // In any case, register this file.
-      m_existingFiles.insert(path);
-
       // Also, only keep files matching the extension
       // provided to this object.
       std::size_t p = name.find_last_of('.');
-      if (p != std::string::npos) {
-        std::string ext = name.substr(p + 1u);
-        if (ext != m_ext) {
-          continue;
-        }
-
-        name = name.substr(0, p);
+      if (p == std::string::npos || name.substr(p + 1u) != m_ext) {
+        continue;
       }
 
+      name = name.substr(0, p);
+
       if (name.empty()) {
         warn("Failed to interpret saved game \"" + path + "\"");
         continue;
       }
 
-      m_saves.push_back(name);
+      // In case the modification time is not available the
+      // metadata will always be fetched again.
+      std::error_code err;
+      FileTime time = sg.last_write_time(err);
+
+      m_saves.push_back(Entry{name, false, err ? FileTime() : time, sudoku::SaveMetadata()});
+      registerName(name);
     }
 
     // Sort the games in alphabetical order to ease
     // finding a particular game.
-    std::sort(m_saves.begin(), m_saves.end());
+    std::sort(m_saves.begin(), m_saves.end(), compareEntries);
+
+    // Keep the metadata already fetched for games which
+    // were already known and were not modified since then:
+    // both lists are sorted.
+    auto prev = previous.cbegin();
+    for (Entry& e : m_saves) {
+      while (prev != previous.cend() && prev->name < e.name) {
+        ++prev;
+      }
 
-    // Reset the index.
-    m_index = 0u;
+      if (prev != previous.cend() && prev->name == e.name &&
+          e.time != FileTime() && prev->time == e.time)
+      {
+        e.fetched = prev->fetched;
+        e.metadata = prev->metadata;
+      }
+    }
 
-    // Update the display.
-    update();
+    info("Indexed " + std::to_string(m_saves.size()) + " saved game(s) in \"" + m_dir + "\"");
+  }
+
+  void
+  SavedGames::registerName(const std::string& name) {
+    m_existingFiles.insert(m_dir + "/" + name + "." + m_ext);
+
+    // Keep track of the largest index used by generated
+    // names so that new names can be generated directly.
+    constexpr auto prefix = "save_";
+    constexpr auto prefixSize = 5u;
+
+    if (name.compare(0u, prefixSize, prefix) != 0 || name.size() == prefixSize) {
+      return;
+    }
+
+    unsigned id = 0u;
+    for (unsigned c = prefixSize ; c < name.size() ; ++c) {
+      if (name[c] < '0' || name[c] > '9') {
+        return;
+      }
+
+      id = 10u * id + static_cast<unsigned>(name[c] - '0');
+    }
+
+    m_fileIndex = std::max(m_fileIndex, id + 1u);
+  }
+
+  bool
+  SavedGames::loadIndex() {
+    std::ifstream in(m_indexFile);
+    if (!in.good()) {
+      return false;
+    }
+
+    // The first line is the version of the index and the
+    // modification time of the directory, followed by one
+    // saved game per line.
+    std::string version;
+    FileTime::rep ticks;
+    in >> version >> ticks;
+    if (!in.good() || version != indexVersion) {
+      warn("Failed to load index \"" + m_indexFile + "\"", "Invalid header");
+      return false;
+    }
+
+    m_time = FileTime(FileTime::duration(ticks));
+
+    m_saves.clear();
+    m_existingFiles.clear();
+
+    std::string line;
+    std::getline(in, line);
+
+    while (std::getline(in, line)) {
+      Entry e;
+      if (!parseEntry(line, e)) {
+        continue;
+      }
+
+      m_saves.push_back(e);
+      registerName(e.name);
+    }
+
+    // The index is supposed to be sorted already but we
+    // don't want to rely on an external file for this.
+    if (!std::is_sorted(m_saves.begin(), m_saves.end(), compareEntries)) {
+      std::sort(m_saves.begin(), m_saves.end(), compareEntries);
+    }
+
+    debug("Loaded index with " + std::to_string(m_saves.size()) + " saved game(s) from \"" + m_indexFile + "\"");
+
+    return true;
+  }
+
+  void
+  SavedGames::saveIndex() const {
+    // Write to a temporary file and rename it so that a
+    // crash never leaves a partial index behind.
+    std::string tmp = m_indexFile + ".tmp";
+
+    {
+      std::ofstream out(tmp, std::ios::trunc);
+      if (!out.good()) {
+        warn("Failed to save index \"" + m_indexFile + "\"", "Failed to open file");
+        return;
+      }
+
+      out << indexVersion << " " << m_time.time_since_epoch().count() << "\n";
+      for (const Entry& e : m_saves) {
+        out << formatEntry(e) << "\n";
+      }
+
+      if (!out.good()) {
+        warn("Failed to save index \"" + m_indexFile + "\"", "Failed to write file");
+        return;
+      }
+    }
+
+    std::error_code err;
+    std::filesystem::rename(tmp, m_indexFile, err);
+    if (err) {
+      warn("Failed to save index \"" + m_indexFile + "\"", err.message());
+    }
+  }
+
+  void
+  SavedGames::fetchMetadata(Entry& e) {
+    // Only the header of the file is read.
+    std::string file = m_dir + "/" + e.name + "." + m_ext;
+    std::ifstream in(file, std::ios::binary);
+
+    e.fetched = true;
+    if (!in.good() || !sudoku::PackedBoard::readMetadata(in, e.metadata)) {
+      e.metadata = sudoku::SaveMetadata();
+    }
+
+    // The index should be updated to include this data.
+    m_dirty = m_indexed;
   }
 
   std::string
-  SavedGames::generateNewName() const noexcept {
-    // Loop until we find a file name which does not
-    // exist yet in the directory.
-    std::string out = m_dir + "/save_" + std::to_string(m_fileIndex) + "." + m_ext;
+  SavedGames::describe(const Entry& e) const {
+    if (!e.metadata.valid) {
+      return e.name;
+    }
 
-    while (m_existingFiles.count(out) > 0) {
-      ++m_fileIndex;
-      out = m_dir + "/save_" + std::to_string(m_fileIndex) + "." + m_ext;
+    char date[32] = "";
+    std::time_t t = static_cast<std::time_t>(e.metadata.lastPlayed);
+    std::tm tm;
+    if (localtime_r(&t, &tm) != nullptr) {
+      std::strftime(date, sizeof(date), "%m/%d %H:%M", &tm);
     }
 
-    m_existingFiles.insert(out);
+    unsigned progress = 100u * e.metadata.filled / sudoku::counting::cellsCount;
 
-    return out;
+    return e.name + " | " + sudoku::toString(e.metadata.level) +
+           " | " + std::to_string(e.metadata.clues) + " clues" +
+           " | " + std::to_string(progress) + "%" +
+           " | " + date;
+  }
+
+  bool
+  SavedGames::compareEntries(const Entry& lhs, const Entry& rhs) noexcept {
+    return lhs.name < rhs.name;
+  }
+
+  std::string
+  SavedGames::formatEntry(const Entry& e) {
+    // The name is last so that it can contain spaces.
+    const sudoku::SaveMetadata& m = e.metadata;
+
+    return std::to_string(e.fetched ? 1 : 0) + " " +
+           std::to_string(m.valid ? 1 : 0) + " " +
+           std::to_string(static_cast<int>(m.level)) + " " +
+           std::to_string(m.clues) + " " +
+           std::to_string(m.filled) + " " +
+           std::to_string(m.lastPlayed) + " " +
+           std::to_string(e.time.time_since_epoch().count()) + " " +
+           e.name;
+  }
+
+  bool
+  SavedGames::parseEntry(const std::string& line, Entry& e) {
+    std::istringstream in(line);
+
+    int fetched, valid, level;
+    FileTime::rep ticks;
+    sudoku::SaveMetadata& m = e.metadata;
+
+    in >> fetched >> valid >> level >> m.clues >> m.filled >> m.lastPlayed >> ticks;
+    if (!in.good()) {
+      return false;
+    }
+
+    // Skip the separator before the name.
+    in.get();
+    std::getline(in, e.name);
+
+    e.fetched = (fetched != 0);
+    e.time = FileTime(FileTime::duration(ticks));
+    m.valid = (valid != 0);
+    m.level = static_cast<sudoku::Level>(level);
+
+    return !e.name.empty();
+  }
+
+  bool
+  SavedGames::directoryTime(FileTime& time) const noexcept {
+    std::error_code err;
+    time = std::filesystem::last_write_time(m_dir, err);
+
+    return !err;
   }
 
   void
@@ -201,7 +499,22 @@ namespace pge {
 
     unsigned id = 0u;
     for (; id < max ; ++id) {
-      m_games[id]->setText(m_saves[m_index + id]);
+      Entry& e = m_saves[m_index + id];
+
+      // Saves overwritten in place don't change the time of the
+      // directory: check the displayed ones individually.
+      std::error_code err;
+      FileTime time = std::filesystem::last_write_time(m_dir + "/" + e.name + "." + m_ext, err);
+      if (err || time != e.time) {
+        e.time = (err ? FileTime() : time);
+        e.fetched = false;
+      }
+
+      if (!e.fetched) {
+        fetchMetadata(e);
+      }
+
+      m_games[id]->setText(describe(e));
       m_games[id]->setEnabled(true);
     }
 
@@ -3,10 +3,12 @@
 
 # include <string>
 # include <vector>
+# include <filesystem>
 # include <unordered_set>
 # include <core_utils/CoreObject.hh>
 # include <core_utils/Signal.hh>
 # include "Menu.hh"
+# include "PackedBoard.hh"
 
 namespace pge {
 
@@ -24,6 +26,11 @@ namespace pge {
                  const std::string& dir,
                  const std::string& ext) noexcept;
 
+      /**
+       * @brief - Persist the index of the saved games if needed.
+       */
+      ~SavedGames();
+
       /**
        * @brief - Generate the layout of this menu and attach all the
        *          menu that are needed to the input parent.
@@ -36,10 +43,23 @@ namespace pge {
        * @brief - Used to update the list of saved games. It is typically
        *          used in case the load game menu is being displayed to
        *          ensure that we have up to date information in it.
+       *          The directory is only scanned in case its modification
+       *          time changed since the last scan: otherwise the cached
+       *          index is used.
        */
       void
       refresh();
 
+      /**
+       * @brief - Register a game that was just saved in the directory
+       *          so that it is listed right away. The next refresh
+       *          still scans the directory as other changes might
+       *          have happened since the last scan.
+       * @param file - the full path to the saved game.
+       */
+      void
+      registerSave(const std::string& file);
+
       /**
        * @brief - Used to genertae a new name for a saved game in the
        *          directory which is not used yet.
@@ -67,6 +87,115 @@ namespace pge {
       /// @brief - Convenience define for a list of file names.
       using Files = std::unordered_set<std::string>;
 
+      /// @brief - Convenience define for the modification time of
+      /// the directory or of a saved game.
+      using FileTime = std::filesystem::file_time_type;
+
+      /// @brief - Convenience structure describing a saved game.
+      struct Entry {
+        // The name of the saved game (without directory nor
+        // extension).
+        std::string name;
+
+        // Whether the metadata was already fetched from the file.
+        bool fetched;
+
+        // The modification time of the file when the entry was
+        // built: the metadata is fetched again if it changes.
+        FileTime time;
+
+        // The metadata describing the saved game.
+        sudoku::SaveMetadata metadata;
+      };
+
+      /// @brief - Convenience define for a list of saved games.
+      using Entries = std::vector<Entry>;
+
+      /**
+       * @brief - Scan the content of the directory and rebuild the
+       *          list of saved games from it.
+       */
+      void
+      scan();
+
+      /**
+       * @brief - Register the input saved game in the list of files
+       *          existing in the directory and update the index to
+       *          use to generate new names if needed. Note that the
+       *          list of saves is not updated.
+       * @param name - the name of the saved game (without directory
+       *               nor extension).
+       */
+      void
+      registerName(const std::string& name);
+
+      /**
+       * @brief - Attempt to load the index from its file. In case it
+       *          does not exist or is not valid `false` is returned.
+       * @return - `true` if the index could be loaded.
+       */
+      bool
+      loadIndex();
+
+      /**
+       * @brief - Write the index to its file so that it can be used
+       *          in a later session.
+       */
+      void
+      saveIndex() const;
+
+      /**
+       * @brief - Read the metadata of the input saved game from the
+       *          header of its file.
+       * @param e - the entry to update.
+       */
+      void
+      fetchMetadata(Entry& e);
+
+      /**
+       * @brief - Generate the text describing the input saved game
+       *          in the load game screen.
+       * @param e - the saved game to describe.
+       * @return - the text to display.
+       */
+      std::string
+      describe(const Entry& e) const;
+
+      /**
+       * @brief - Used to sort the saved games by name.
+       * @param lhs - the first entry to compare.
+       * @param rhs - the second entry to compare.
+       * @return - `true` if `lhs` comes before `rhs`.
+       */
+      static bool
+      compareEntries(const Entry& lhs, const Entry& rhs) noexcept;
+
+      /**
+       * @brief - Serialize the entry as a line of the index file.
+       * @param e - the entry to serialize.
+       * @return - the line representing the entry.
+       */
+      static std::string
+      formatEntry(const Entry& e);
+
+      /**
+       * @brief - Parse a line of the index file.
+       * @param line - the line to parse.
+       * @param e - output argument receiving the entry.
+       * @return - `true` if the line is valid.
+       */
+      static bool
+      parseEntry(const std::string& line, Entry& e);
+
+      /**
+       * @brief - Fetch the modification time of the directory where
+       *          games are saved.
+       * @param time - output argument receiving the time.
+       * @return - `true` if the time could be fetched.
+       */
+      bool
+      directoryTime(FileTime& time) const noexcept;
+
       /**
        * @brief - The directory where saved games are stored.
        */
@@ -77,11 +206,38 @@ namespace pge {
        */
       std::string m_ext;
 
+      /**
+       * @brief - The path to the file holding the index of the saved
+       *          games. It is located next to the directory so that
+       *          writing it does not change the modification time of
+       *          the directory.
+       */
+      std::string m_indexFile;
+
+      /**
+       * @brief - Whether or not the list of saved games is valid. It
+       *          is not the case until the index is loaded or until
+       *          the directory is scanned.
+       */
+      bool m_indexed;
+
+      /**
+       * @brief - Whether or not the index changed since it was last
+       *          written to its file.
+       */
+      bool m_dirty;
+
+      /**
+       * @brief - The modification time of the directory when it was
+       *          last indexed.
+       */
+      FileTime m_time;
+
       /**
        * @brief - The list of saved games as listed in the directory where
-       *          games are stored.
+       *          games are stored, sorted by name.
        */
-      std::vector<std::string> m_saves;
+      Entries m_saves;
 
       /**
        * @brief - The index of the first element displayed in the load game
@@ -113,7 +269,9 @@ namespace pge {
 
       /**
        * @brief - The current index reached when requesting new
-       *          names for saved files.
+       *          names for saved files. It is kept past the largest
+       *          index used by the existing saves so that finding a
+       *          free name does not require probing all of them.
        */
       mutable unsigned m_fileIndex;
 
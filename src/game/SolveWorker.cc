@@ -0,0 +1,70 @@
+
+#include "SolveWorker.hh"
+#include "Trace.hh"
+#include <chrono>
+
+namespace sudoku {
+
+SolveWorker::SolveWorker()
+    : RequestWorker("solver", Policy::Latest),
+
+      m_progress(), m_solver() {
+  m_solver.monitor(&m_progress);
+
+  start();
+}
+
+SolveWorker::~SolveWorker() { stop(); }
+
+unsigned long SolveWorker::solve(const algorithm::Grid &grid, bool record) {
+  return submit(SolveRequest{grid, record});
+}
+
+void SolveWorker::cancel() { RequestWorker::cancel(); }
+
+unsigned SolveWorker::nodes() const noexcept {
+  return m_progress.nodes.load(std::memory_order_relaxed);
+}
+
+SolveWorker::Result SolveWorker::process(unsigned long id,
+                                         const SolveRequest &request) {
+  Result res{id, false, false, {}, 0u, 0.0f, nullptr};
+
+  std::shared_ptr<algorithm::StepLog> log;
+  if (request.record) {
+    log = std::make_shared<algorithm::StepLog>();
+  }
+  m_solver.record(log.get());
+
+  {
+    trace::Scope scope("solve", "solver");
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    m_solver.load(request.grid);
+    res.solved = (m_solver.solve() > 0u);
+    res.cancelled = m_solver.cancelled();
+
+    std::chrono::duration<float, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    res.duration = elapsed.count();
+  }
+
+  res.solution = m_solver.solution();
+  res.nodes = m_solver.nodes();
+  res.log = log;
+
+  return res;
+}
+
+void SolveWorker::interrupt() noexcept {
+  // The search in progress is not relevant anymore.
+  m_progress.cancel.store(true, std::memory_order_relaxed);
+}
+
+void SolveWorker::prepare() noexcept {
+  m_progress.nodes.store(0u, std::memory_order_relaxed);
+  m_progress.cancel.store(false, std::memory_order_relaxed);
+}
+
+} // namespace sudoku
@@ -0,0 +1,109 @@
+#ifndef SOLVE_WORKER_HH
+#define SOLVE_WORKER_HH
+
+#include "CandidateSolver.hh"
+#include "RequestWorker.hh"
+#include <memory>
+
+namespace sudoku {
+
+/// @brief - A puzzle to solve and whether the steps of its search
+/// should be recorded.
+struct SolveRequest {
+  algorithm::Grid grid;
+  bool record;
+};
+
+/// @brief - The outcome of a request to solve a puzzle.
+struct SolveResult {
+  // The identifier of the request, as returned by `solve`.
+  unsigned long id;
+
+  // Whether the request was interrupted before completing.
+  bool cancelled;
+
+  // Whether a solution was found.
+  bool solved;
+
+  // The solution of the puzzle if one was found.
+  algorithm::Grid solution;
+
+  // The number of nodes explored by the search.
+  unsigned nodes;
+
+  // The duration of the search in milliseconds.
+  float duration;
+
+  // The steps of the search, if they were recorded.
+  std::shared_ptr<const algorithm::StepLog> log;
+};
+
+/// @brief - Solves puzzles on a dedicated thread so that hard
+/// puzzles never stall the caller. A single puzzle is solved at a
+/// time: a new request interrupts the one in progress. The number
+/// of nodes explored can be followed while the search runs and the
+/// results are handed back through a lock-free queue.
+class SolveWorker : public RequestWorker<SolveRequest, SolveResult, 8u> {
+public:
+  /// @brief - The outcome of a request.
+  using Result = SolveResult;
+
+  /**
+   * @brief - Create a new worker and start its thread.
+   */
+  SolveWorker();
+
+  /**
+   * @brief - Interrupt the search in progress and stop the thread.
+   */
+  ~SolveWorker() override;
+
+  /**
+   * @brief - Register a new puzzle to solve, interrupting the one
+   *          in progress if any. This method returns right away
+   *          and the result can be fetched with `poll`.
+   * @param grid - the puzzle to solve.
+   * @param record - whether the steps of the search should be
+   *                 recorded to be replayed.
+   * @return - the identifier of the request.
+   */
+  unsigned long solve(const algorithm::Grid &grid, bool record = false);
+
+  /**
+   * @brief - Interrupt the request in progress, if any: it is still
+   *          reported through `poll` as cancelled.
+   */
+  void cancel();
+
+  /**
+   * @brief - The number of nodes explored so far by the search in
+   *          progress, updated regularly while it runs.
+   * @return - the number of nodes.
+   */
+  unsigned nodes() const noexcept;
+
+protected:
+  Result process(unsigned long id, const SolveRequest &request) override;
+
+  void interrupt() noexcept override;
+
+  void prepare() noexcept override;
+
+private:
+  /**
+   * @brief - Shared with the solver to follow and interrupt the
+   *          search in progress.
+   */
+  algorithm::Progress m_progress;
+
+  /**
+   * @brief - The solver performing the searches, only accessed by
+   *          the worker thread.
+   */
+  algorithm::CandidateSolver m_solver;
+};
+
+using SolveWorkerShPtr = std::shared_ptr<SolveWorker>;
+} // namespace sudoku
+
+#endif /* SOLVE_WORKER_HH */
@@ -0,0 +1,77 @@
+#ifndef SPSC_QUEUE_HH
+#define SPSC_QUEUE_HH
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace sudoku {
+
+/// @brief - A bounded queue where a single thread pushes elements
+/// and a single other thread pops them, without any lock. The
+/// indices keep growing and are wrapped when accessing the slots,
+/// which is why the capacity must be a power of two.
+template <typename Element, std::size_t Capacity> class SpscQueue {
+  static_assert((Capacity & (Capacity - 1u)) == 0u,
+                "Capacity must be a power of two");
+
+public:
+  /**
+   * @brief - Create an empty queue.
+   */
+  SpscQueue() noexcept : m_slots(), m_head(0u), m_tail(0u) {}
+
+  /**
+   * @brief - Append an element to the queue. Must only be called
+   *          by the producer thread.
+   * @param element - the element to append.
+   * @return - `false` if the queue is full, in which case the
+   *           element is not appended.
+   */
+  bool push(const Element &element) noexcept {
+    std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+
+    m_slots[tail & (Capacity - 1u)] = element;
+    m_tail.store(tail + 1u, std::memory_order_release);
+
+    return true;
+  }
+
+  /**
+   * @brief - Remove the oldest element of the queue. Must only be
+   *          called by the consumer thread.
+   * @param element - output receiving the element.
+   * @return - `false` if the queue is empty.
+   */
+  bool pop(Element &element) noexcept {
+    std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    // Move the element out so that the slot does not keep the
+    // resources it owns alive until it is reused.
+    element = std::move(m_slots[head & (Capacity - 1u)]);
+    m_head.store(head + 1u, std::memory_order_release);
+
+    return true;
+  }
+
+private:
+  /// @brief - The storage of the elements.
+  std::array<Element, Capacity> m_slots;
+
+  /// @brief - The number of elements popped and pushed so far. They
+  /// are updated by different threads so they live in different
+  /// cache lines.
+  alignas(64) std::atomic<std::size_t> m_head;
+  alignas(64) std::atomic<std::size_t> m_tail;
+};
+
+} // namespace sudoku
+
+#endif /* SPSC_QUEUE_HH */
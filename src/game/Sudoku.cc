@@ -1,30 +1,14 @@
 
 #include "Sudoku.hh"
 #include <core_utils/Chrono.hh>
-
-namespace {
-
-unsigned levelToNumbers(const sudoku::Level &level) noexcept {
-  switch (level) {
-  case sudoku::Level::Medium:
-    return 20u;
-  case sudoku::Level::Hard:
-    return 15u;
-  case sudoku::Level::Easy:
-  default:
-    // Similar to the easy mode.
-    return 25u;
-  }
-}
-
-} // namespace
+#include <core_utils/TimeUtils.hh>
 
 namespace sudoku {
 
 Game::Game(const Level &level) noexcept
     : utils::CoreObject("board"),
 
-      m_board(), m_level(level) {
+      m_board(), m_level(level), m_journal(nullptr), m_autoMarks(false) {
   setService("sudoku");
 }
 
@@ -34,29 +18,64 @@ unsigned Game::h() const noexcept { return m_board.h(); }
 
 const Board &Game::operator()() const noexcept { return m_board; }
 
-void Game::clear() noexcept { m_board.reset(); }
+void Game::clear() noexcept {
+  m_board.reset();
+  m_autoMarks = false;
+  restartJournal();
+}
 
 void Game::initialize() noexcept {
   // Reset the board and generate it with a certain
   // amount of numbers visible still.
   m_board.reset();
+  m_autoMarks = false;
 
   bool generated = false;
   withSafetyNet(
       [this, &generated]() {
         utils::ChronoMilliseconds c("Solving Sudoku", "solver");
-        generated = m_board.generate(levelToNumbers(m_level));
+        generated = m_board.generate(toClues(m_level));
       },
       "Board::generate");
 
   if (!generated) {
     error("Failed to generate sudoku");
   }
+
+  restartJournal();
+}
+
+void Game::initialize(const PackedBoard &board) {
+  m_board.unpack(board);
+  m_autoMarks = false;
+  restartJournal();
+}
+
+void Game::load(const std::string &file) {
+  SaveMetadata meta;
+  m_board.load(file, &meta);
+  m_autoMarks = false;
+
+  if (meta.valid) {
+    m_level = meta.level;
+  }
+
+  restartJournal();
+}
+
+SaveMetadata Game::metadata() const noexcept {
+  std::int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                         utils::now().time_since_epoch())
+                         .count();
+
+  return m_board.pack().metadata(m_level, now);
 }
 
-void Game::load(const std::string &file) { m_board.load(file); }
+Level Game::level() const noexcept { return m_level; }
 
-void Game::save(const std::string &file) const { m_board.save(file); }
+void Game::save(const std::string &file) const {
+  m_board.save(file, metadata());
+}
 
 bool Game::put(unsigned x, unsigned y, unsigned digit, const DigitKind &kind,
                ConstraintKind *reason) {
@@ -70,11 +89,113 @@ bool Game::put(unsigned x, unsigned y, unsigned digit, const DigitKind &kind,
     return false;
   }
 
-  m_board.put(x, y, digit, kind);
+  if (m_journal != nullptr) {
+    Journal::Move m;
+    m.cell = y * w() + x;
+    m.oldDigit = m_board.at(x, y, &m.oldKind);
+    m.newDigit = digit;
+    m.newKind = (digit == 0u ? DigitKind::None : kind);
+
+    m_journal->record(m);
+  }
+
+  place(x, y, digit, kind);
+
+  // Avoid replaying an ever growing list of moves in case
+  // of a recovery.
+  if (m_journal != nullptr && m_journal->compactable()) {
+    m_journal->compact(m_board.pack(), metadata());
+  }
 
   return true;
 }
 
 bool Game::solved() const noexcept { return m_board.solved(); }
 
+void Game::toggleMark(unsigned x, unsigned y, unsigned digit) {
+  m_board.toggleMark(x, y, digit);
+}
+
+void Game::fillMarks() noexcept {
+  m_board.fillMarks();
+  m_autoMarks = true;
+}
+
+void Game::clearMarks() noexcept {
+  m_board.clearMarks();
+  m_autoMarks = false;
+}
+
+void Game::setJournal(JournalShPtr journal) {
+  if (m_journal == journal) {
+    return;
+  }
+
+  m_journal = journal;
+  restartJournal();
+}
+
+bool Game::recover(JournalShPtr journal) {
+  PackedBoard board;
+  SaveMetadata meta;
+
+  if (journal == nullptr || !journal->recover(board, meta)) {
+    return false;
+  }
+
+  m_board.unpack(board);
+  m_autoMarks = false;
+  if (meta.valid) {
+    m_level = meta.level;
+  }
+
+  m_journal = journal;
+
+  return true;
+}
+
+bool Game::undo() {
+  Journal::Move m;
+  if (m_journal == nullptr || !m_journal->undo(m)) {
+    return false;
+  }
+
+  apply(m.cell, m.oldDigit, m.oldKind);
+
+  return true;
+}
+
+bool Game::redo() {
+  Journal::Move m;
+  if (m_journal == nullptr || !m_journal->redo(m)) {
+    return false;
+  }
+
+  apply(m.cell, m.newDigit, m.newKind);
+
+  return true;
+}
+
+void Game::restartJournal() {
+  if (m_journal != nullptr) {
+    m_journal->start(m_board.pack(), metadata());
+  }
+}
+
+void Game::apply(unsigned cell, unsigned digit, const DigitKind &kind) {
+  place(cell % w(), cell / w(), digit, kind);
+}
+
+void Game::place(unsigned x, unsigned y, unsigned digit,
+                 const DigitKind &kind) {
+  unsigned previous = m_board.at(x, y);
+  m_board.put(x, y, digit, kind);
+
+  // Putting a digit prunes the marks of its peers but removing one
+  // does not restore them.
+  if (m_autoMarks && previous != 0u) {
+    m_board.refreshMarks(x, y);
+  }
+}
+
 } // namespace sudoku
@@ -2,6 +2,8 @@
 #define SUDOKU_HH
 
 #include "Board.hh"
+#include "Journal.hh"
+#include "PackedBoard.hh"
 #include <core_utils/CoreObject.hh>
 #include <memory>
 #include <unordered_set>
@@ -9,9 +11,6 @@
 
 namespace sudoku {
 
-/// @brief - The complexity of the game we are generating.
-enum class Level { Easy, Medium, Hard };
-
 class Game : public utils::CoreObject {
 public:
   /**
@@ -49,14 +48,35 @@ public:
    */
   void initialize() noexcept;
 
+  /**
+   * @brief - Initialize the board with a game generated beforehand,
+   *          for example in the background.
+   * @param board - the generated board.
+   */
+  void initialize(const PackedBoard &board);
+
   /**
    * @brief - Loads the content of the board defined in the
    *          input file and use it to replace the content
-   *          of this board.
+   *          of this board. In case the file defines the level
+   *          of the game it is restored as well.
    * @param file - the file defining the board's data.
    */
   void load(const std::string &file);
 
+  /**
+   * @brief - Generate the metadata describing the current state
+   *          of the game, as saved in the header of save files.
+   * @return - the metadata for this game.
+   */
+  SaveMetadata metadata() const noexcept;
+
+  /**
+   * @brief - The difficulty level of the game.
+   * @return - the difficulty level.
+   */
+  Level level() const noexcept;
+
   /**
    * @brief - Used to perform the saving of this board to the
    *          provided file.
@@ -78,6 +98,86 @@ public:
 
   bool solved() const noexcept;
 
+  /**
+   * @brief - Add or remove a digit from the pencil marks of an
+   *          empty cell. The marks are not recorded in the journal.
+   * @param x - one of the coordinate of the cell.
+   * @param y - one of the coordinate of the cell.
+   * @param digit - the digit to toggle.
+   */
+  void toggleMark(unsigned x, unsigned y, unsigned digit);
+
+  /**
+   * @brief - Mark all the digits which can be put in each empty
+   *          cell of the board. Until `clearMarks` is called or
+   *          the board is replaced, the marks of the cells in the
+   *          row, column and box of a removed digit are filled
+   *          again as well, including through `undo` and `redo`.
+   */
+  void fillMarks() noexcept;
+
+  /**
+   * @brief - Remove all the pencil marks of the board.
+   */
+  void clearMarks() noexcept;
+
+  /**
+   * @brief - Attach a journal recording the moves performed on
+   *          this game. The journal is started from the current
+   *          state of the board. Passing `nullptr` detaches the
+   *          current journal.
+   * @param journal - the journal to attach.
+   */
+  void setJournal(JournalShPtr journal);
+
+  /**
+   * @brief - Rebuild the session saved in the input journal and
+   *          attach it to this game.
+   * @param journal - the journal to recover.
+   * @return - `true` if the session could be recovered.
+   */
+  bool recover(JournalShPtr journal);
+
+  /**
+   * @brief - Revert the last move performed on the board. This
+   *          requires a journal to be attached.
+   * @return - `true` if a move was reverted.
+   */
+  bool undo();
+
+  /**
+   * @brief - Apply again the last move reverted with `undo`.
+   * @return - `true` if a move was applied.
+   */
+  bool redo();
+
+private:
+  /**
+   * @brief - Start the journal again from the current state of
+   *          the board, in case one is attached.
+   */
+  void restartJournal();
+
+  /**
+   * @brief - Apply the input digit to the board without any
+   *          check and without recording it.
+   * @param cell - the linear index of the cell.
+   * @param digit - the digit to put.
+   * @param kind - the kind of the digit.
+   */
+  void apply(unsigned cell, unsigned digit, const DigitKind &kind);
+
+  /**
+   * @brief - Put the input digit on the board, refreshing the
+   *          marks around the cell if a digit was removed while
+   *          they are filled automatically.
+   * @param x - one of the coordinate of the cell.
+   * @param y - one of the coordinate of the cell.
+   * @param digit - the digit to put.
+   * @param kind - the kind of the digit.
+   */
+  void place(unsigned x, unsigned y, unsigned digit, const DigitKind &kind);
+
 private:
   /**
    * @brief - The current state of the board.
@@ -88,6 +188,18 @@ private:
    * @brief - The difficulty level.
    */
   Level m_level;
+
+  /**
+   * @brief - The journal recording the moves performed on the
+   *          board, if any.
+   */
+  JournalShPtr m_journal;
+
+  /**
+   * @brief - Whether the marks are filled automatically with the
+   *          digits which can be put in each cell.
+   */
+  bool m_autoMarks;
 };
 
 using GameShPtr = std::shared_ptr<Game>;
@@ -1,7 +1,11 @@
 
 #include "Board.hh"
+#include "Allocations.hh"
 #include "Definitions.hh"
+#include "Metrics.hh"
+#include "PackedBoard.hh"
 #include "SudokuMatrix.hh"
+#include "Trace.hh"
 #include <cmath>
 #include <core_utils/RNG.hh>
 #include <fstream>
@@ -9,6 +13,34 @@
 namespace sudoku {
 namespace {
 
+metrics::Histogram &generateDuration() {
+  static metrics::Histogram &histogram = metrics::registry().histogram(
+      "sudoku_generate_seconds", "Time spent generating a puzzle",
+      metrics::exponentialBounds(0.01, 2.0, 12));
+  return histogram;
+}
+
+metrics::Histogram &loadDuration() {
+  static metrics::Histogram &histogram = metrics::registry().histogram(
+      "sudoku_load_seconds", "Time spent loading a game",
+      metrics::exponentialBounds(0.0001, 2.0, 14));
+  return histogram;
+}
+
+/// @brief - The mask where all the candidates are set.
+constexpr std::uint16_t allCandidates = (1u << counting::candidates) - 1u;
+
+/// @brief - The bit of the input digit in the masks of digits, or
+/// `0` for an empty cell (or an invalid digit).
+inline std::uint16_t bitOf(unsigned digit) noexcept {
+  return (digit >= 1u && digit <= counting::candidates ? 1u << (digit - 1u)
+                                                       : 0u);
+}
+
+inline unsigned boxOf(unsigned x, unsigned y) noexcept {
+  return counting::boxIDFromRowAndColumn(y, x);
+}
+
 /// @brief - A convenience structure representing a digit
 /// at a specific position.
 struct DigitAt {
@@ -93,6 +125,13 @@ bool canFitInBox(const std::vector<unsigned> &board,
 
 } // namespace
 
+metrics::Histogram &saveDuration() {
+  static metrics::Histogram &histogram = metrics::registry().histogram(
+      "sudoku_save_seconds", "Time spent saving a game",
+      metrics::exponentialBounds(0.0001, 2.0, 14));
+  return histogram;
+}
+
 std::string toString(const ConstraintKind &constraint) noexcept {
   switch (constraint) {
   case ConstraintKind::Row:
@@ -108,10 +147,38 @@ std::string toString(const ConstraintKind &constraint) noexcept {
   }
 }
 
+std::string toString(const Level &level) noexcept {
+  switch (level) {
+  case Level::Easy:
+    return "Easy";
+  case Level::Medium:
+    return "Medium";
+  case Level::Hard:
+    return "Hard";
+  default:
+    return "Unknown";
+  }
+}
+
+unsigned toClues(const Level &level) noexcept {
+  switch (level) {
+  case Level::Medium:
+    return 20u;
+  case Level::Hard:
+    return 15u;
+  case Level::Easy:
+  default:
+    // Similar to the easy mode.
+    return 25u;
+  }
+}
+
 Board::Board() noexcept
     : utils::CoreObject("board"), m_width(9u), m_height(9u),
       m_board(w() * h(), 0u), m_kinds(w() * h(), DigitKind::None) {
   setService("sudoku");
+
+  m_counts[0u] = w() * h();
 }
 
 unsigned Board::w() const noexcept { return m_width; }
@@ -142,6 +209,12 @@ unsigned Board::at(unsigned x, unsigned y, DigitKind *kind) const {
   return m_board[linear(x, y)];
 }
 
+unsigned Board::count(unsigned digit) const noexcept {
+  return (digit < m_counts.size() ? m_counts[digit] : 0u);
+}
+
+unsigned long Board::revision() const noexcept { return m_revision; }
+
 bool Board::canFit(unsigned x, unsigned y, unsigned digit,
                    ConstraintKind *reason) const {
   if (x >= m_width || y >= m_height) {
@@ -149,9 +222,12 @@ bool Board::canFit(unsigned x, unsigned y, unsigned digit,
           "Invalid coordinate " + std::to_string(x) + "x" + std::to_string(y));
   }
 
+  // The masks only track valid digits: other values are checked
+  // by scanning the board.
+  std::uint16_t bit = bitOf(digit);
   DigitAt d{digit, x, y, m_width, m_height};
 
-  if (!canFitInColumn(m_board, d)) {
+  if (bit != 0u ? (m_columns[x] & bit) != 0u : !canFitInColumn(m_board, d)) {
     verbose("Digit " + std::to_string(digit) + " doesn't fit in column " +
             std::to_string(x));
 
@@ -162,7 +238,7 @@ bool Board::canFit(unsigned x, unsigned y, unsigned digit,
     return false;
   }
 
-  if (!canFitInRow(m_board, d)) {
+  if (bit != 0u ? (m_rows[y] & bit) != 0u : !canFitInRow(m_board, d)) {
     verbose("Digit " + std::to_string(digit) + " doesn't fit in row " +
             std::to_string(y));
 
@@ -173,7 +249,8 @@ bool Board::canFit(unsigned x, unsigned y, unsigned digit,
     return false;
   }
 
-  if (!canFitInBox(m_board, d)) {
+  if (bit != 0u ? (m_boxes[boxOf(x, y)] & bit) != 0u
+                 : !canFitInBox(m_board, d)) {
     verbose("Digit " + std::to_string(digit) + " doesn't fit in box " +
             std::to_string(1u + x / 3u) + "x" + std::to_string(1u + y / 3u));
 
@@ -201,48 +278,186 @@ void Board::put(unsigned x, unsigned y, unsigned digit, const DigitKind &kind) {
           "Invalid digit " + std::to_string(digit) + " not in range [0; 9]");
   }
 
-  m_board[linear(x, y)] = digit;
+  unsigned &cell = m_board[linear(x, y)];
+
+  // Replacing a digit by another one does not change the number of
+  // digits on the board.
+  if (cell == 0u && digit != 0u) {
+    ++m_digits;
+  }
+  if (cell != 0u && digit == 0u) {
+    --m_digits;
+  }
+
+  if (cell < m_counts.size()) {
+    --m_counts[cell];
+  }
+  ++m_counts[digit];
+
+  unsigned previous = cell;
+
+  cell = digit;
   m_kinds[linear(x, y)] = (digit == 0u ? DigitKind::None : kind);
+  ++m_revision;
+
+  // Removing a digit requires to look at the other cells as it
+  // may be used several times in a unit of an invalid board.
+  std::uint16_t bit = bitOf(digit);
+  if (previous != 0u) {
+    updateConstraints(x, y);
+  } else if (bit != 0u) {
+    m_rows[y] |= bit;
+    m_columns[x] |= bit;
+    m_boxes[boxOf(x, y)] |= bit;
+  }
 
-  m_digits += (digit == 0u ? -1 : 1);
+  // The digit can't be a candidate of its peers anymore.
+  if (bit != 0u) {
+    m_marks[linear(x, y)] = 0u;
 
-  // Update the solved status if all digits are filled.*
-  m_solved = false;
-  if (m_digits == static_cast<int>(w() * h())) {
-    algorithm::SudokuMatrix solver;
-    m_solved = solver.solvable(*this);
+    unsigned bx = (x / counting::boxXCellsCount) * counting::boxXCellsCount;
+    unsigned by = (y / counting::boxYCellsCount) * counting::boxYCellsCount;
+
+    for (unsigned id = 0u; id < counting::candidates; ++id) {
+      m_marks[linear(id, y)] &= ~bit;
+      m_marks[linear(x, id)] &= ~bit;
+      m_marks[linear(bx + id % counting::boxXCellsCount,
+                     by + id / counting::boxXCellsCount)] &= ~bit;
+    }
   }
+
+  updateSolved();
+}
+
+std::uint16_t Board::candidates(unsigned x, unsigned y) const {
+  if (x >= m_width || y >= m_height) {
+    error("Failed to fetch candidates",
+          "Invalid coordinate " + std::to_string(x) + "x" + std::to_string(y));
+  }
+
+  if (m_board[linear(x, y)] != 0u) {
+    return 0u;
+  }
+
+  return allCandidates & ~(m_rows[y] | m_columns[x] | m_boxes[boxOf(x, y)]);
+}
+
+std::uint16_t Board::marks(unsigned x, unsigned y) const {
+  if (x >= m_width || y >= m_height) {
+    error("Failed to fetch marks",
+          "Invalid coordinate " + std::to_string(x) + "x" + std::to_string(y));
+  }
+
+  return m_marks[linear(x, y)];
+}
+
+void Board::toggleMark(unsigned x, unsigned y, unsigned digit) {
+  if (x >= m_width || y >= m_height) {
+    error("Failed to toggle mark",
+          "Invalid coordinate " + std::to_string(x) + "x" + std::to_string(y));
+  }
+
+  std::uint16_t bit = bitOf(digit);
+  if (bit == 0u || m_board[linear(x, y)] != 0u) {
+    return;
+  }
+
+  m_marks[linear(x, y)] ^= bit;
+  ++m_revision;
+}
+
+void Board::fillMarks() noexcept {
+  for (unsigned y = 0u; y < m_height; ++y) {
+    for (unsigned x = 0u; x < m_width; ++x) {
+      m_marks[linear(x, y)] = candidates(x, y);
+    }
+  }
+
+  ++m_revision;
+}
+
+void Board::refreshMarks(unsigned x, unsigned y) {
+  if (x >= m_width || y >= m_height) {
+    error("Failed to refresh marks",
+          "Invalid coordinate " + std::to_string(x) + "x" + std::to_string(y));
+  }
+
+  unsigned bx = (x / counting::boxXCellsCount) * counting::boxXCellsCount;
+  unsigned by = (y / counting::boxYCellsCount) * counting::boxYCellsCount;
+
+  for (unsigned id = 0u; id < counting::candidates; ++id) {
+    unsigned cx = bx + id % counting::boxXCellsCount;
+    unsigned cy = by + id / counting::boxXCellsCount;
+
+    m_marks[linear(id, y)] = candidates(id, y);
+    m_marks[linear(x, id)] = candidates(x, id);
+    m_marks[linear(cx, cy)] = candidates(cx, cy);
+  }
+
+  ++m_revision;
+}
+
+void Board::clearMarks() noexcept {
+  m_marks.fill(0u);
+  ++m_revision;
 }
 
 void Board::reset() noexcept {
   m_board = std::vector<unsigned>(w() * h(), 0u);
   m_kinds = std::vector<DigitKind>(w() * h(), DigitKind::None);
   m_digits = 0;
+  m_counts.fill(0u);
+  m_counts[0u] = w() * h();
+  m_rows.fill(0u);
+  m_columns.fill(0u);
+  m_boxes.fill(0u);
+  m_marks.fill(0u);
+  m_solved = false;
+  ++m_revision;
 }
 
 bool Board::generate(unsigned digits) noexcept {
+  utils::RNG rng;
+  return generate(digits, rng);
+}
+
+bool Board::generate(unsigned digits, utils::RNG &rng,
+                     const std::atomic<bool> *stop) {
+  trace::Scope scope("generate", "solver");
+  allocations::Scope allocs(allocations::Category::Generate);
+  metrics::Timer timer(generateDuration());
+
   if (digits > counting::cellsCount) {
     return false;
   }
 
-  utils::RNG rng;
-
   // Put a random digit somewhere to initialize the
   // board. This will prevent identical sudokus to
-  // be generated.
-  unsigned digit = rng.rndInt(1, counting::candidates);
-  unsigned x = rng.rndInt(0u, counting::columnsCount - 1u);
-  unsigned y = rng.rndInt(0u, counting::rowsCount - 1u);
+  // be generated. The solver does not backtrack so
+  // some starting positions lead it to a dead end:
+  // another digit is drawn in this case.
+  constexpr auto maxStartAttempts = 16u;
 
-  debug("Starting with seed " + std::to_string(digit) + " at " +
-      std::to_string(x) + "x" + std::to_string(y));
+  std::stack<sudoku::algorithm::MatrixNode> nodes;
+  for (unsigned attempt = 0u; attempt < maxStartAttempts && nodes.empty();
+       ++attempt) {
+    unsigned digit = rng.rndInt(1, counting::candidates);
+    unsigned x = rng.rndInt(0u, counting::columnsCount - 1u);
+    unsigned y = rng.rndInt(0u, counting::rowsCount - 1u);
 
-  m_board[y * m_width + x] = digit;
+    debug("Starting with seed " + std::to_string(digit) + " at " +
+        std::to_string(x) + "x" + std::to_string(y));
 
-  // Solve the sudoku.
-  std::stack<sudoku::algorithm::MatrixNode> nodes;
-  sudoku::algorithm::SudokuMatrix solver;
-  nodes = solver.solve(*this);
+    put(x, y, digit, DigitKind::Generated);
+
+    // Solve the sudoku.
+    sudoku::algorithm::SudokuMatrix solver;
+    nodes = solver.solve(*this);
+
+    if (nodes.empty()) {
+      put(x, y, 0u, DigitKind::None);
+    }
+  }
 
   if (nodes.empty()) {
     error("Failed to generate sudoku");
@@ -267,13 +482,14 @@ bool Board::generate(unsigned digits) noexcept {
   // tolerate when generating the sudoku.
   constexpr auto maxFailues = 81;
 
-  while (removed < toRemove && failures <= maxFailues) {
+  while (removed < toRemove && failures <= maxFailues &&
+         (stop == nullptr || !stop->load(std::memory_order_relaxed))) {
     unsigned x = rng.rndInt(0u, counting::columnsCount - 1u);
     unsigned y = rng.rndInt(0u, counting::rowsCount - 1u);
 
     // Remove the digit.
     DigitKind kind;
-    digit = at(x, y, &kind);
+    unsigned digit = at(x, y, &kind);
 
     put(x, y, 0u, DigitKind::None);
 
@@ -293,94 +509,184 @@ bool Board::generate(unsigned digits) noexcept {
     }
   }
 
-  info("Generated sudoku with " + std::to_string(digits) + " after " +
-       std::to_string(totalFailures) + " failure(s)");
-
-  m_digits = static_cast<int>(digits);
+  info("Generated sudoku with " + std::to_string(counting::cellsCount - removed) +
+       " digit(s) after " + std::to_string(totalFailures) + " failure(s)");
 
   return true;
 }
 
-void Board::save(const std::string &file) const {
-  // Open the file and verify that it is valid.
-  std::ofstream out(file.c_str());
-  if (!out.good()) {
-    error("Failed to save board to \"" + file + "\"", "Failed to open file");
-  }
+PackedBoard Board::pack() const noexcept {
+  PackedBoard out;
 
-  unsigned buf, size = sizeof(unsigned);
-  const char *raw = reinterpret_cast<const char *>(&buf);
+  for (unsigned id = 0u; id < m_board.size(); ++id) {
+    out.set(id, m_board[id], m_kinds[id]);
+  }
 
-  std::vector<char> kBuf;
-  unsigned kSize = sizeof(std::underlying_type<DigitKind>::type);
-  kBuf.resize(kSize);
-  const char *kRaw = kBuf.data();
+  return out;
+}
 
-  // Save the dimensions of the board.
-  buf = m_width;
-  out.write(raw, size);
+void Board::unpack(const PackedBoard &packed) {
+  m_width = counting::columnsCount;
+  m_height = counting::rowsCount;
 
-  buf = m_height;
-  out.write(raw, size);
+  m_board.resize(m_width * m_height);
+  m_kinds.resize(m_width * m_height);
 
-  // Save the content board.
   for (unsigned id = 0u; id < m_board.size(); ++id) {
-    buf = m_board[id];
-    out.write(raw, size);
+    m_board[id] = packed.digit(id);
+    m_kinds[id] = packed.kind(id);
+  }
+
+  updateStatus();
+}
+
+void Board::save(const std::string &file,
+                 const SaveMetadata &metadata) const {
+  trace::Scope scope("save", "io");
+  metrics::Timer timer(saveDuration());
 
-    kRaw = reinterpret_cast<char *>(&m_kinds[id]);
-    out.write(kRaw, kSize);
+  // Open the file and verify that it is valid.
+  std::ofstream out(file.c_str(), std::ios::binary);
+  if (!out.good()) {
+    error("Failed to save board to \"" + file + "\"", "Failed to open file");
+  }
+
+  pack().save(out, metadata);
+  out.flush();
+
+  // A short write (e.g. when the disk is full) would otherwise go
+  // unnoticed.
+  if (!out.good()) {
+    error("Failed to save board to \"" + file + "\"",
+          "Failed to write file");
   }
 
   info("Saved content of board with dimensions " + std::to_string(m_width) +
        "x" + std::to_string(m_height) + " to \"" + file + "\"");
 }
 
-void Board::load(const std::string &file) {
+void Board::load(const std::string &file, SaveMetadata *metadata) {
+  trace::Scope scope("load", "io");
+  metrics::Timer timer(loadDuration());
+
   // Open the file and verify that it is valid.
-  std::ifstream out(file.c_str());
-  if (!out.good()) {
+  std::ifstream in(file.c_str(), std::ios::binary);
+  if (!in.good()) {
     error("Failed to load board to \"" + file + "\"", "Failed to open file");
   }
 
-  out.read(reinterpret_cast<char *>(&m_width), sizeof(unsigned));
-  out.read(reinterpret_cast<char *>(&m_height), sizeof(unsigned));
+  PackedBoard packed;
+  SaveMetadata meta;
+  if (packed.load(in, &meta)) {
+    unpack(packed);
+  } else {
+    loadLegacy(in, file);
+  }
+
+  if (metadata != nullptr) {
+    *metadata = meta;
+  }
+
+  info("Loaded board with dimensions " + std::to_string(m_width) + "x" +
+       std::to_string(m_height));
+}
+
+inline unsigned Board::linear(unsigned x, unsigned y) const noexcept {
+  return y * m_width + x;
+}
+
+void Board::loadLegacy(std::istream &in, const std::string &file) {
+  unsigned width = 0u, height = 0u;
+  in.read(reinterpret_cast<char *>(&width), sizeof(unsigned));
+  in.read(reinterpret_cast<char *>(&height), sizeof(unsigned));
 
   // Consistency check.
-  if (m_width == 0u || m_height == 0u) {
+  if (width != counting::columnsCount || height != counting::rowsCount) {
     error("Failed to load board from file \"" + file + "\"",
-          "Invalid board of size " + std::to_string(m_width) + "x" +
-              std::to_string(m_height));
+          "Invalid board of size " + std::to_string(width) + "x" +
+              std::to_string(height));
   }
 
+  m_width = width;
+  m_height = height;
+
   // Read the content of the board.
   m_board = std::vector<unsigned>(m_width * m_height, 0u);
   m_kinds = std::vector<DigitKind>(m_width * m_height, DigitKind::None);
 
   for (unsigned id = 0u; id < m_board.size(); ++id) {
-    out.read(reinterpret_cast<char *>(&m_board[id]), sizeof(unsigned));
-    out.read(reinterpret_cast<char *>(&m_kinds[id]),
-             sizeof(std::underlying_type<DigitKind>::type));
+    in.read(reinterpret_cast<char *>(&m_board[id]), sizeof(unsigned));
+    in.read(reinterpret_cast<char *>(&m_kinds[id]),
+            sizeof(std::underlying_type<DigitKind>::type));
   }
 
-  info("Loaded board with dimensions " + std::to_string(m_width) + "x" +
-       std::to_string(m_height));
+  updateStatus();
+}
+
+void Board::updateStatus() {
+  ++m_revision;
 
   m_digits = 0;
+  m_counts.fill(0u);
+
   for (unsigned id = 0u; id < m_board.size(); ++id) {
     if (m_board[id] != 0u) {
       ++m_digits;
     }
+
+    // Digits out of range are only possible with corrupted legacy
+    // files: they are ignored by the counts.
+    if (m_board[id] < m_counts.size()) {
+      ++m_counts[m_board[id]];
+    }
   }
 
+  // The marks of the previous content are not relevant.
+  m_marks.fill(0u);
+  updateConstraints();
+
+  updateSolved();
+}
+
+void Board::updateSolved() {
+  m_solved = false;
   if (m_digits == static_cast<int>(w() * h())) {
     algorithm::SudokuMatrix solver;
     m_solved = solver.solvable(*this);
   }
 }
 
-inline unsigned Board::linear(unsigned x, unsigned y) const noexcept {
-  return y * m_width + x;
+void Board::updateConstraints(unsigned x, unsigned y) noexcept {
+  unsigned box = boxOf(x, y);
+  unsigned bx = (x / counting::boxXCellsCount) * counting::boxXCellsCount;
+  unsigned by = (y / counting::boxYCellsCount) * counting::boxYCellsCount;
+
+  m_rows[y] = 0u;
+  m_columns[x] = 0u;
+  m_boxes[box] = 0u;
+
+  for (unsigned id = 0u; id < counting::candidates; ++id) {
+    m_rows[y] |= bitOf(m_board[linear(id, y)]);
+    m_columns[x] |= bitOf(m_board[linear(x, id)]);
+    m_boxes[box] |= bitOf(m_board[linear(bx + id % counting::boxXCellsCount,
+                                         by + id / counting::boxXCellsCount)]);
+  }
+}
+
+void Board::updateConstraints() noexcept {
+  m_rows.fill(0u);
+  m_columns.fill(0u);
+  m_boxes.fill(0u);
+
+  for (unsigned y = 0u; y < m_height; ++y) {
+    for (unsigned x = 0u; x < m_width; ++x) {
+      std::uint16_t bit = bitOf(m_board[linear(x, y)]);
+
+      m_rows[y] |= bit;
+      m_columns[x] |= bit;
+      m_boxes[boxOf(x, y)] |= bit;
+    }
+  }
 }
 
 } // namespace sudoku
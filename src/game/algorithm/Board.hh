@@ -1,10 +1,18 @@
 #ifndef BOARD_HH
 #define BOARD_HH
 
+#include <array>
+#include <atomic>
 #include <core_utils/CoreObject.hh>
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <vector>
 
+namespace utils {
+class RNG;
+}
+
 namespace sudoku {
 
 /// @brief - The kind of digit: allows to determine whether
@@ -22,6 +30,29 @@ enum class ConstraintKind { Row, Column, Box, None };
 
 std::string toString(const ConstraintKind &constraint) noexcept;
 
+/// @brief - The complexity of the game we are generating.
+enum class Level { Easy, Medium, Hard };
+
+std::string toString(const Level &level) noexcept;
+
+/// @brief - The number of digits initially visible on a board
+/// generated for the input difficulty level.
+unsigned toClues(const Level &level) noexcept;
+
+// Forward declaration of the packed representation of a board
+// and of the information saved alongside it.
+class PackedBoard;
+struct SaveMetadata;
+
+namespace metrics {
+class Histogram;
+}
+
+/// @brief - The histogram of the durations of the saves, shared by
+/// the boards and the `SaveWorker` so that both kinds of saves are
+/// reported in the same metric.
+metrics::Histogram &saveDuration();
+
 class Board : public utils::CoreObject {
 public:
   /**
@@ -63,6 +94,24 @@ public:
    */
   unsigned at(unsigned x, unsigned y, DigitKind *kind = nullptr) const;
 
+  /**
+   * @brief - The number of cells holding the input digit. The counts
+   *          are maintained when the board is modified so this does
+   *          not scan the board.
+   * @param digit - the digit to count (`0` counts the empty cells).
+   * @return - the number of cells holding the digit or `0` if it is
+   *           not a valid digit.
+   */
+  unsigned count(unsigned digit) const noexcept;
+
+  /**
+   * @brief - A counter incremented each time the content of the
+   *          board changes. It allows to detect modifications
+   *          without comparing the cells.
+   * @return - the revision of the board.
+   */
+  unsigned long revision() const noexcept;
+
   /**
    * @brief - Allow to determine whether or not the input number
    *          can fit at the specified location.
@@ -76,7 +125,21 @@ public:
               ConstraintKind *reason = nullptr) const;
 
   /**
-   * @brief - Put a number at a certain spot.
+   * @brief - The digits which can be put in the input cell given
+   *          the digits of its row, column and box. The digits of
+   *          each row, column and box are maintained as masks when
+   *          the board is modified so this does not scan the board.
+   * @param x - the input coordinate.
+   * @param y - the input coordinate.
+   * @return - the mask of candidates where bit `d` is set if the
+   *           digit `d + 1` fits in the cell, `0` if it is filled.
+   */
+  std::uint16_t candidates(unsigned x, unsigned y) const;
+
+  /**
+   * @brief - Put a number at a certain spot. Putting a digit also
+   *          removes it from the pencil marks of the cells of the
+   *          same row, column and box.
    * @param x - one of the coordinate where to put the digit.
    * @param y - one of the coordinate where to put the digit.
    * @param digit - the digit to put.
@@ -84,6 +147,46 @@ public:
    */
   void put(unsigned x, unsigned y, unsigned digit, const DigitKind &kind);
 
+  /**
+   * @brief - The pencil marks of the input cell: the digits the
+   *          player considers for this cell.
+   * @param x - the input coordinate.
+   * @param y - the input coordinate.
+   * @return - the mask of marks where bit `d` is set if the digit
+   *           `d + 1` is marked.
+   */
+  std::uint16_t marks(unsigned x, unsigned y) const;
+
+  /**
+   * @brief - Add or remove a digit from the pencil marks of an
+   *          empty cell. Nothing happens for a filled cell.
+   * @param x - the input coordinate.
+   * @param y - the input coordinate.
+   * @param digit - the digit to toggle, in the range `[1; 9]`.
+   */
+  void toggleMark(unsigned x, unsigned y, unsigned digit);
+
+  /**
+   * @brief - Replace the pencil marks of all the empty cells with
+   *          the digits which can be put in them.
+   */
+  void fillMarks() noexcept;
+
+  /**
+   * @brief - Replace the pencil marks of the empty cells in the
+   *          row, column and box of the input cell with the digits
+   *          which can be put in them. This restores the marks
+   *          pruned by a digit which was removed from the cell.
+   * @param x - the input coordinate.
+   * @param y - the input coordinate.
+   */
+  void refreshMarks(unsigned x, unsigned y);
+
+  /**
+   * @brief - Remove all the pencil marks of the board.
+   */
+  void clearMarks() noexcept;
+
   /**
    * @brief - Reset all tiles to be empty.
    */
@@ -101,24 +204,96 @@ public:
    */
   bool generate(unsigned digits) noexcept;
 
+  /**
+   * @brief - Similar to `generate` but draws the random values from
+   *          the input generator: this allows to produce the same
+   *          board again from a fixed seed. Unlike `generate` this
+   *          method reports failures of the solver by throwing.
+   * @param digits - the number of digits to leave on the board.
+   * @param rng - the random number generator to use.
+   * @param stop - when set by another thread, no more digits are
+   *               removed: the board then keeps more digits than
+   *               requested (which makes it simpler) but is still
+   *               a valid puzzle.
+   * @return - `true` if the game could be generated.
+   */
+  bool generate(unsigned digits, utils::RNG &rng,
+                const std::atomic<bool> *stop = nullptr);
+
+  /**
+   * @brief - Produce a compact snapshot of the content of this
+   *          board.
+   * @return - the packed representation of the board.
+   */
+  PackedBoard pack() const noexcept;
+
+  /**
+   * @brief - Replace the content of this board with the one
+   *          defined in the input snapshot.
+   * @param packed - the snapshot to restore.
+   */
+  void unpack(const PackedBoard &packed);
+
   /**
    * @brief - Used to perform the saving of this board to the
    *          provided file.
    * @param file - the name of the file to save the board to.
+   * @param metadata - the information to save in the header of
+   *                   the file.
    */
-  void save(const std::string &file) const;
+  void save(const std::string &file, const SaveMetadata &metadata) const;
 
   /**
    * @brief - Loads the content of the board defined in the
    *          input file and use it to replace the content
-   *          of this board.
+   *          of this board. Both the packed format and the
+   *          legacy format (one integer per digit and kind) are
+   *          supported.
    * @param file - the file defining the board's data.
+   * @param metadata - optional argument receiving the information
+   *                   saved in the header of the file. It is marked
+   *                   as invalid for files which do not have one.
    */
-  void load(const std::string &file);
+  void load(const std::string &file, SaveMetadata *metadata = nullptr);
 
 private:
   unsigned linear(unsigned x, unsigned y) const noexcept;
 
+  /**
+   * @brief - Read the content of the board from the input stream
+   *          assuming it is in the legacy format.
+   * @param in - the stream to read from.
+   * @param file - the name of the file (for logging purposes).
+   */
+  void loadLegacy(std::istream &in, const std::string &file);
+
+  /**
+   * @brief - Update the number of digits, the count of each digit
+   *          and the solved status from the current content of the
+   *          board.
+   */
+  void updateStatus();
+
+  /**
+   * @brief - Update the solved status after a modification of the
+   *          board: it can only be solved when all cells are filled.
+   */
+  void updateSolved();
+
+  /**
+   * @brief - Compute again the digits used by the row, column and
+   *          box of the input cell.
+   * @param x - the abscissa of the cell.
+   * @param y - the ordinate of the cell.
+   */
+  void updateConstraints(unsigned x, unsigned y) noexcept;
+
+  /**
+   * @brief - Compute again the digits used by all the rows, columns
+   *          and boxes of the board.
+   */
+  void updateConstraints() noexcept;
+
 private:
   /**
    * @brief - The width of the board.
@@ -144,6 +319,28 @@ private:
 
   int m_digits{0};
 
+  /**
+   * @brief - The number of cells holding each digit, indexed by the
+   *          digit (the first entry counts the empty cells).
+   */
+  std::array<unsigned, 10u> m_counts{};
+
+  /**
+   * @brief - The digits used in each row, column and box, where bit
+   *          `d` is set if the digit `d + 1` is used.
+   */
+  std::array<std::uint16_t, 9u> m_rows{};
+  std::array<std::uint16_t, 9u> m_columns{};
+  std::array<std::uint16_t, 9u> m_boxes{};
+
+  /**
+   * @brief - The pencil marks of each cell, stored in the same way
+   *          as the candidates.
+   */
+  std::array<std::uint16_t, 81u> m_marks{};
+
+  unsigned long m_revision{0u};
+
   bool m_solved{false};
 };
 
@@ -0,0 +1,67 @@
+
+#include "CandidateGrid.hh"
+
+namespace sudoku::algorithm {
+
+CandidateGrid::CandidateGrid() noexcept
+    : m_grid(), m_rows(), m_columns(), m_boxes(),
+      m_empty(counting::cellsCount) {
+  m_grid.fill(0u);
+  m_rows.fill(0u);
+  m_columns.fill(0u);
+  m_boxes.fill(0u);
+}
+
+bool CandidateGrid::load(const Grid &grid) noexcept {
+  m_grid.fill(0u);
+  m_rows.fill(0u);
+  m_columns.fill(0u);
+  m_boxes.fill(0u);
+  m_empty = counting::cellsCount;
+
+  for (unsigned cell = 0u; cell < counting::cellsCount; ++cell) {
+    unsigned digit = grid[cell];
+    if (digit == 0u) {
+      continue;
+    }
+
+    // Detect invalid digits and conflicts between the digits
+    // of the puzzle.
+    if (digit > counting::candidates ||
+        (candidates(cell) & (1u << (digit - 1u))) == 0u) {
+      return false;
+    }
+
+    assign(cell, digit);
+  }
+
+  return true;
+}
+
+unsigned CandidateGrid::pick(unsigned &cell, std::uint16_t &mask) const
+    noexcept {
+  unsigned bestCount = counting::candidates + 1u;
+
+  for (unsigned id = 0u; id < counting::cellsCount; ++id) {
+    if (m_grid[id] != 0u) {
+      continue;
+    }
+
+    std::uint16_t available = candidates(id);
+    unsigned count = __builtin_popcount(available);
+
+    if (count < bestCount) {
+      cell = id;
+      mask = available;
+      bestCount = count;
+
+      if (count <= 1u) {
+        break;
+      }
+    }
+  }
+
+  return bestCount;
+}
+
+} // namespace sudoku::algorithm
@@ -0,0 +1,133 @@
+#ifndef CANDIDATE_GRID_HH
+#define CANDIDATE_GRID_HH
+
+#include "Definitions.hh"
+#include <array>
+#include <cstdint>
+
+namespace sudoku::algorithm {
+
+/// @brief - The digits of a board stored in a flat array where
+/// each cell contains a digit in the range `[0; 9]` (zero meaning
+/// that the cell is empty).
+using Grid = std::array<std::uint8_t, counting::cellsCount>;
+
+/// @brief - The state shared by the backtracking solvers: a grid
+/// along with the digits used in each row, column and box kept as
+/// bit masks, so that the candidates of a cell are known at once.
+class CandidateGrid {
+public:
+  /// @brief - The mask where all the candidates are set.
+  static constexpr std::uint16_t allCandidates =
+      (1u << counting::candidates) - 1u;
+
+  /**
+   * @brief - Create a new empty grid.
+   */
+  CandidateGrid() noexcept;
+
+  /**
+   * @brief - Reset the grid with the digits of the input one.
+   * @param grid - the digits to load.
+   * @return - `false` if the digits of the grid are invalid or
+   *           conflict with each other, in which case the loading
+   *           stops at the first faulty digit.
+   */
+  bool load(const Grid &grid) noexcept;
+
+  /**
+   * @brief - The digits currently assigned.
+   * @return - the grid.
+   */
+  const Grid &grid() const noexcept { return m_grid; }
+
+  /**
+   * @brief - The digit of the input cell.
+   * @param cell - the linear index of the cell.
+   * @return - the digit, or `0` if the cell is empty.
+   */
+  unsigned at(unsigned cell) const noexcept { return m_grid[cell]; }
+
+  /**
+   * @brief - The number of empty cells in the grid.
+   * @return - the number of empty cells.
+   */
+  unsigned empty() const noexcept { return m_empty; }
+
+  /**
+   * @brief - The candidates available for the input cell.
+   * @param cell - the linear index of the cell.
+   * @return - the mask of candidates where bit `d` is set if the
+   *           digit `d + 1` can be put in the cell.
+   */
+  std::uint16_t candidates(unsigned cell) const noexcept {
+    unsigned row = cell / counting::columnsCount;
+    unsigned column = cell % counting::columnsCount;
+
+    return allCandidates &
+           ~(m_rows[row] | m_columns[column] |
+             m_boxes[counting::boxIDFromRowAndColumn(row, column)]);
+  }
+
+  /**
+   * @brief - Put or remove a digit in the input cell, updating
+   *          the masks of the constraints.
+   * @param cell - the linear index of the cell.
+   * @param digit - the digit to put (or `0` to clear the cell).
+   */
+  void assign(unsigned cell, unsigned digit) noexcept {
+    unsigned row = cell / counting::columnsCount;
+    unsigned column = cell % counting::columnsCount;
+    unsigned box = counting::boxIDFromRowAndColumn(row, column);
+
+    if (digit == 0u) {
+      std::uint16_t bit = 1u << (m_grid[cell] - 1u);
+
+      m_rows[row] &= ~bit;
+      m_columns[column] &= ~bit;
+      m_boxes[box] &= ~bit;
+
+      m_grid[cell] = 0u;
+      ++m_empty;
+
+      return;
+    }
+
+    std::uint16_t bit = 1u << (digit - 1u);
+
+    m_rows[row] |= bit;
+    m_columns[column] |= bit;
+    m_boxes[box] |= bit;
+
+    m_grid[cell] = static_cast<std::uint8_t>(digit);
+    --m_empty;
+  }
+
+  /**
+   * @brief - Pick the empty cell with the fewest candidates: this
+   *          keeps the branching factor of a search as low as
+   *          possible. The grid must have at least one empty cell.
+   * @param cell - output receiving the linear index of the cell.
+   * @param mask - output receiving the candidates of the cell.
+   * @return - the number of candidates of the cell, `0` meaning
+   *           that the grid can't be completed.
+   */
+  unsigned pick(unsigned &cell, std::uint16_t &mask) const noexcept;
+
+private:
+  /// @brief - The digits assigned to each cell.
+  Grid m_grid;
+
+  /// @brief - The digits used in each row, column and box.
+  std::array<std::uint16_t, counting::rowsCount> m_rows;
+  std::array<std::uint16_t, counting::columnsCount> m_columns;
+  std::array<std::uint16_t, counting::boxesXCount * counting::boxesYCount>
+      m_boxes;
+
+  /// @brief - The number of empty cells in the grid.
+  unsigned m_empty;
+};
+
+} // namespace sudoku::algorithm
+
+#endif /* CANDIDATE_GRID_HH */
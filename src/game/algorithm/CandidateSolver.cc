@@ -0,0 +1,181 @@
+
+#include "CandidateSolver.hh"
+#include "Allocations.hh"
+
+namespace sudoku::algorithm {
+namespace {
+
+/// @brief - The maximum number of guesses for a puzzle to be
+/// considered of medium difficulty.
+constexpr unsigned mediumGuesses = 8u;
+
+/// @brief - The progress of a monitored search is reported each
+/// time the number of nodes explored is a multiple of 1024.
+constexpr unsigned reportMask = 1023u;
+
+} // namespace
+
+std::string toString(const Status &status) noexcept {
+  switch (status) {
+  case Status::Invalid:
+    return "invalid";
+  case Status::Unsolvable:
+    return "unsolvable";
+  case Status::Unique:
+    return "unique";
+  case Status::Multiple:
+    return "multiple";
+  default:
+    return "unknown";
+  }
+}
+
+CandidateSolver::CandidateSolver() noexcept
+    : m_puzzle(), m_grid(), m_solution(), m_valid(true), m_solutions(0u),
+      m_nodes(0u), m_guesses(0u), m_progress(nullptr), m_cancelled(false),
+      m_log(nullptr) {
+  m_puzzle.fill(0u);
+  m_solution.fill(0u);
+}
+
+bool CandidateSolver::load(const Grid &grid) noexcept {
+  m_puzzle = grid;
+  m_solution.fill(0u);
+
+  m_solutions = 0u;
+  m_nodes = 0u;
+  m_guesses = 0u;
+
+  m_valid = m_grid.load(m_puzzle);
+
+  return m_valid;
+}
+
+bool CandidateSolver::load(const Board &board) {
+  Grid grid;
+
+  for (unsigned y = 0u; y < counting::rowsCount; ++y) {
+    for (unsigned x = 0u; x < counting::columnsCount; ++x) {
+      grid[y * counting::columnsCount + x] =
+          static_cast<std::uint8_t>(board.at(x, y));
+    }
+  }
+
+  return load(grid);
+}
+
+unsigned CandidateSolver::solve(unsigned limit) noexcept {
+  allocations::Scope allocs(allocations::Category::Solve);
+
+  m_solutions = 0u;
+  m_nodes = 0u;
+  m_guesses = 0u;
+  m_cancelled = false;
+
+  if (!m_valid || limit == 0u) {
+    return 0u;
+  }
+
+  search(limit);
+
+  if (m_progress != nullptr) {
+    m_progress->nodes.store(m_nodes, std::memory_order_relaxed);
+  }
+
+  return m_solutions;
+}
+
+Status CandidateSolver::status() noexcept {
+  if (!m_valid) {
+    return Status::Invalid;
+  }
+
+  switch (solve(2u)) {
+  case 0u:
+    return Status::Unsolvable;
+  case 1u:
+    return Status::Unique;
+  default:
+    return Status::Multiple;
+  }
+}
+
+const Grid &CandidateSolver::solution() const noexcept { return m_solution; }
+
+unsigned CandidateSolver::nodes() const noexcept { return m_nodes; }
+
+unsigned CandidateSolver::guesses() const noexcept { return m_guesses; }
+
+void CandidateSolver::monitor(Progress *progress) noexcept {
+  m_progress = progress;
+}
+
+bool CandidateSolver::cancelled() const noexcept { return m_cancelled; }
+
+void CandidateSolver::record(StepLog *log) noexcept { m_log = log; }
+
+Level CandidateSolver::difficulty() const noexcept {
+  if (m_guesses == 0u) {
+    return Level::Easy;
+  }
+  if (m_guesses <= mediumGuesses) {
+    return Level::Medium;
+  }
+
+  return Level::Hard;
+}
+
+void CandidateSolver::search(unsigned limit) noexcept {
+  if (m_grid.empty() == 0u) {
+    if (m_solutions == 0u) {
+      m_solution = m_grid.grid();
+    }
+
+    ++m_solutions;
+    return;
+  }
+
+  unsigned best = counting::cellsCount;
+  std::uint16_t bestMask = 0u;
+  unsigned bestCount = m_grid.pick(best, bestMask);
+
+  if (bestCount == 0u) {
+    return;
+  }
+  if (bestCount > 1u) {
+    ++m_guesses;
+  }
+
+  while (bestMask != 0u && m_solutions < limit && !m_cancelled) {
+    unsigned digit = __builtin_ctz(bestMask) + 1u;
+    bestMask &= bestMask - 1u;
+
+    m_grid.assign(best, digit);
+    ++m_nodes;
+
+    if (m_log != nullptr) {
+      m_log->place(best, digit);
+    }
+
+    if (m_progress != nullptr && (m_nodes & reportMask) == 0u) {
+      report();
+    }
+
+    search(limit);
+
+    m_grid.assign(best, 0u);
+
+    // The cells are also cleared when unwinding after the last
+    // solution was found: this is not a dead end.
+    if (m_log != nullptr && m_solutions < limit) {
+      m_log->backtrack(best, digit);
+    }
+  }
+}
+
+void CandidateSolver::report() noexcept {
+  m_progress->nodes.store(m_nodes, std::memory_order_relaxed);
+  m_cancelled = m_progress->cancel.load(std::memory_order_relaxed);
+}
+
+} // namespace sudoku::algorithm
@@ -0,0 +1,163 @@
+#ifndef CANDIDATE_SOLVER_HH
+#define CANDIDATE_SOLVER_HH
+
+#include "Board.hh"
+#include "CandidateGrid.hh"
+#include "StepLog.hh"
+#include <atomic>
+
+namespace sudoku::algorithm {
+
+/// @brief - The status of a puzzle as determined by the solver.
+enum class Status { Invalid, Unsolvable, Unique, Multiple };
+
+std::string toString(const Status &status) noexcept;
+
+/// @brief - Allows another thread to follow a search: the solver
+/// publishes the number of nodes explored regularly and stops as
+/// soon as it notices that `cancel` is set.
+struct Progress {
+  std::atomic<unsigned> nodes{0u};
+  std::atomic<bool> cancel{false};
+};
+
+/// @brief - A backtracking solver keeping the candidates of each
+/// row, column and box as bit masks. Cells are filled in order of
+/// the fewest candidates first. Unlike `SudokuMatrix` it explores
+/// all the possibilities which allows to count the solutions of a
+/// puzzle and to estimate its difficulty.
+class CandidateSolver {
+public:
+  /**
+   * @brief - Create a new solver with an empty grid.
+   */
+  CandidateSolver() noexcept;
+
+  /**
+   * @brief - Reset the solver with the digits of the input grid.
+   * @param grid - the puzzle to solve.
+   * @return - `false` if the digits of the grid conflict with each
+   *           other.
+   */
+  bool load(const Grid &grid) noexcept;
+
+  /**
+   * @brief - Reset the solver with the digits of the input board.
+   * @param board - the puzzle to solve.
+   * @return - `false` if the digits of the board conflict with
+   *           each other.
+   */
+  bool load(const Board &board);
+
+  /**
+   * @brief - Search for the solutions of the puzzle loaded in the
+   *          solver, stopping once `limit` solutions are found.
+   *          The first solution found is available through the
+   *          `solution` method.
+   * @param limit - the maximum number of solutions to look for.
+   * @return - the number of solutions found.
+   */
+  unsigned solve(unsigned limit = 1u) noexcept;
+
+  /**
+   * @brief - Determine whether the puzzle loaded in the solver has
+   *          no solution, a single one or several ones.
+   * @return - the status of the puzzle.
+   */
+  Status status() noexcept;
+
+  /**
+   * @brief - The first solution found by the last call to `solve`.
+   * @return - the solution of the puzzle.
+   */
+  const Grid &solution() const noexcept;
+
+  /**
+   * @brief - The number of cells assigned during the last search.
+   * @return - the number of nodes explored.
+   */
+  unsigned nodes() const noexcept;
+
+  /**
+   * @brief - The number of cells where the last search had to pick
+   *          among several candidates.
+   * @return - the number of guesses.
+   */
+  unsigned guesses() const noexcept;
+
+  /**
+   * @brief - Estimate the difficulty of the puzzle from the effort
+   *          needed by the last search: puzzles which can be solved
+   *          without guessing are easy.
+   * @return - the difficulty of the puzzle.
+   */
+  Level difficulty() const noexcept;
+
+  /**
+   * @brief - Attach a structure to report the progress of the next
+   *          searches to and to interrupt them.
+   * @param progress - the progress to update, or `null` to stop
+   *                   reporting.
+   */
+  void monitor(Progress *progress) noexcept;
+
+  /**
+   * @brief - Whether the last search was interrupted through the
+   *          monitored progress before completing.
+   * @return - `true` if the search was cancelled.
+   */
+  bool cancelled() const noexcept;
+
+  /**
+   * @brief - Attach a log to record the placements and backtracks
+   *          of the next searches into.
+   * @param log - the log to append the steps to, or `null` to stop
+   *              recording.
+   */
+  void record(StepLog *log) noexcept;
+
+private:
+  /**
+   * @brief - Explore the possibilities for the remaining cells.
+   * @param limit - the maximum number of solutions to look for.
+   */
+  void search(unsigned limit) noexcept;
+
+  /**
+   * @brief - Publish the number of nodes explored to the monitored
+   *          progress and check whether the search is cancelled.
+   */
+  void report() noexcept;
+
+private:
+  /// @brief - The initial digits of the puzzle.
+  Grid m_puzzle;
+
+  /// @brief - The current state of the grid during the search.
+  CandidateGrid m_grid;
+
+  /// @brief - The first solution found.
+  Grid m_solution;
+
+  /// @brief - Whether the digits of the puzzle are consistent.
+  bool m_valid;
+
+  /// @brief - The number of solutions found so far.
+  unsigned m_solutions;
+
+  /// @brief - Statistics about the last search.
+  unsigned m_nodes;
+  unsigned m_guesses;
+
+  /// @brief - The progress reported to another thread, if any, and
+  /// whether the last search was cancelled.
+  Progress *m_progress;
+  bool m_cancelled;
+
+  /// @brief - The log recording the steps of the search, if any.
+  StepLog *m_log;
+};
+
+} // namespace sudoku::algorithm
+
+#endif /* CANDIDATE_SOLVER_HH */
@@ -0,0 +1,191 @@
+
+#include "PackedBoard.hh"
+#include <cstring>
+
+namespace sudoku {
+namespace {
+
+/// @brief - The magic bytes identifying a packed board.
+constexpr char magic[] = {'S', 'D', 'K', 'P'};
+
+/// @brief - The version of the packed format. The first version
+/// did not have any metadata.
+constexpr std::uint8_t version = 2u;
+constexpr std::uint8_t noMetadataVersion = 1u;
+
+/// @brief - The size of the header preceding the packed data:
+/// the magic, the version and the dimensions of the board.
+constexpr unsigned headerSize = sizeof(magic) + 4u;
+
+/// @brief - The size of the metadata block following the header.
+constexpr unsigned metadataSize = 12u;
+
+/// @brief - Read the header at the start of the input stream
+/// and returns the version of the format (or `0` in case the
+/// header is not valid).
+std::uint8_t readHeader(std::istream &in) {
+  char header[headerSize];
+  in.read(header, headerSize);
+
+  if (!in.good() || std::memcmp(header, magic, sizeof(magic)) != 0 ||
+      header[sizeof(magic) + 1u] != counting::columnsCount ||
+      header[sizeof(magic) + 2u] != counting::rowsCount) {
+    return 0u;
+  }
+
+  std::uint8_t v = static_cast<std::uint8_t>(header[sizeof(magic)]);
+  return (v == version || v == noMetadataVersion ? v : 0u);
+}
+
+void encode(const SaveMetadata &metadata, char *buf) noexcept {
+  buf[0] = static_cast<char>(metadata.valid ? 1 : 0);
+  buf[1] = static_cast<char>(metadata.level);
+  buf[2] = static_cast<char>(metadata.clues);
+  buf[3] = static_cast<char>(metadata.filled);
+
+  // Always use little endian for the time.
+  std::uint64_t t = static_cast<std::uint64_t>(metadata.lastPlayed);
+  for (unsigned id = 0u; id < 8u; ++id) {
+    buf[4u + id] = static_cast<char>((t >> (8u * id)) & 0xFFu);
+  }
+}
+
+bool decode(const char *buf, SaveMetadata &out) noexcept {
+  // Reject unknown levels rather than building an invalid value.
+  std::uint8_t level = static_cast<std::uint8_t>(buf[1]);
+  if (level > static_cast<std::uint8_t>(Level::Hard)) {
+    return false;
+  }
+
+  out.valid = (buf[0] & 1) != 0;
+  out.level = static_cast<Level>(level);
+  out.clues = static_cast<std::uint8_t>(buf[2]);
+  out.filled = static_cast<std::uint8_t>(buf[3]);
+
+  std::uint64_t t = 0u;
+  for (unsigned id = 0u; id < 8u; ++id) {
+    t |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(buf[4u + id]))
+         << (8u * id);
+  }
+  out.lastPlayed = static_cast<std::int64_t>(t);
+
+  return true;
+}
+
+} // namespace
+
+PackedBoard::PackedBoard() noexcept : m_data() { m_data.fill(0u); }
+
+unsigned PackedBoard::digit(unsigned id) const noexcept {
+  std::uint8_t b = m_data[id / 2u];
+  return (id % 2u == 0u ? b & 0xFu : b >> 4u);
+}
+
+DigitKind PackedBoard::kind(unsigned id) const noexcept {
+  std::uint8_t b = m_data[digitsBytes + id / 4u];
+  return static_cast<DigitKind>((b >> (2u * (id % 4u))) & 0x3u);
+}
+
+void PackedBoard::set(unsigned id, unsigned digit,
+                      const DigitKind &kind) noexcept {
+  std::uint8_t &d = m_data[id / 2u];
+  unsigned dShift = 4u * (id % 2u);
+  d = static_cast<std::uint8_t>((d & ~(0xFu << dShift)) |
+                                ((digit & 0xFu) << dShift));
+
+  std::uint8_t &k = m_data[digitsBytes + id / 4u];
+  unsigned kShift = 2u * (id % 4u);
+  unsigned raw = static_cast<unsigned>(kind) & 0x3u;
+  k = static_cast<std::uint8_t>((k & ~(0x3u << kShift)) | (raw << kShift));
+}
+
+SaveMetadata PackedBoard::metadata(const Level &level,
+                                   std::int64_t lastPlayed) const noexcept {
+  SaveMetadata out;
+
+  out.valid = true;
+  out.level = level;
+  out.lastPlayed = lastPlayed;
+
+  for (unsigned id = 0u; id < counting::cellsCount; ++id) {
+    if (digit(id) == 0u) {
+      continue;
+    }
+
+    ++out.filled;
+    if (kind(id) == DigitKind::Generated) {
+      ++out.clues;
+    }
+  }
+
+  return out;
+}
+
+void PackedBoard::save(std::ostream &out, const SaveMetadata &metadata) const {
+  char buf[headerSize + metadataSize + bytes];
+
+  std::memcpy(buf, magic, sizeof(magic));
+  buf[sizeof(magic)] = static_cast<char>(version);
+  buf[sizeof(magic) + 1u] = static_cast<char>(counting::columnsCount);
+  buf[sizeof(magic) + 2u] = static_cast<char>(counting::rowsCount);
+  buf[sizeof(magic) + 3u] = 0;
+
+  encode(metadata, buf + headerSize);
+
+  std::memcpy(buf + headerSize + metadataSize, m_data.data(), bytes);
+
+  out.write(buf, sizeof(buf));
+}
+
+bool PackedBoard::load(std::istream &in, SaveMetadata *metadata) {
+  std::istream::pos_type start = in.tellg();
+
+  std::uint8_t v = readHeader(in);
+  SaveMetadata meta;
+  bool decoded = true;
+
+  if (v == version) {
+    char buf[metadataSize];
+    in.read(buf, metadataSize);
+    decoded = in.good() && decode(buf, meta);
+  }
+
+  bool valid = (v != 0u && decoded && in.good());
+  if (valid) {
+    in.read(reinterpret_cast<char *>(m_data.data()), bytes);
+    valid = in.good();
+  }
+
+  if (!valid) {
+    in.clear();
+    in.seekg(start);
+    return false;
+  }
+
+  if (metadata != nullptr) {
+    *metadata = meta;
+  }
+
+  return true;
+}
+
+bool PackedBoard::readMetadata(std::istream &in, SaveMetadata &metadata) {
+  if (readHeader(in) != version) {
+    return false;
+  }
+
+  char buf[metadataSize];
+  in.read(buf, metadataSize);
+
+  return in.good() && decode(buf, metadata);
+}
+
+bool PackedBoard::operator==(const PackedBoard &rhs) const noexcept {
+  return m_data == rhs.m_data;
+}
+
+bool PackedBoard::operator!=(const PackedBoard &rhs) const noexcept {
+  return !operator==(rhs);
+}
+
+} // namespace sudoku
@@ -0,0 +1,136 @@
+#ifndef PACKED_BOARD_HH
+#define PACKED_BOARD_HH
+
+#include "Board.hh"
+#include "Definitions.hh"
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace sudoku {
+
+/// @brief - A small fixed-size block of information saved at the
+/// start of each saved game. It allows to describe a save without
+/// having to read the whole board.
+struct SaveMetadata {
+  // Whether the information is available: this is not the case for
+  // files written in a format without metadata.
+  bool valid{false};
+
+  // The difficulty level of the game.
+  Level level{Level::Medium};
+
+  // The number of digits initially present on the board.
+  unsigned clues{0u};
+
+  // The number of cells filled on the board.
+  unsigned filled{0u};
+
+  // The last time the game was played, expressed in seconds
+  // since the epoch.
+  std::int64_t lastPlayed{0};
+};
+
+/// @brief - A compact representation of the content of a board:
+/// each digit is stored on 4 bits and each kind on 2 bits. This
+/// is used both as a cheap in-memory snapshot of a board and as
+/// the payload of the saved games.
+class PackedBoard {
+public:
+  /// @brief - The number of bytes needed to store the digits.
+  static constexpr unsigned digitsBytes = (counting::cellsCount + 1u) / 2u;
+
+  /// @brief - The number of bytes needed to store the kinds.
+  static constexpr unsigned kindsBytes = (counting::cellsCount + 3u) / 4u;
+
+  /// @brief - The total size of the packed representation.
+  static constexpr unsigned bytes = digitsBytes + kindsBytes;
+
+  /**
+   * @brief - Create a new packed board where all cells are empty.
+   */
+  PackedBoard() noexcept;
+
+  /**
+   * @brief - Returns the digit stored in the cell at the input
+   *          linear index (or zero if the cell is empty).
+   * @param id - the linear index of the cell.
+   * @return - the digit stored in the cell.
+   */
+  unsigned digit(unsigned id) const noexcept;
+
+  /**
+   * @brief - Returns the kind of the digit stored at the input
+   *          linear index.
+   * @param id - the linear index of the cell.
+   * @return - the kind of the digit in the cell.
+   */
+  DigitKind kind(unsigned id) const noexcept;
+
+  /**
+   * @brief - Update the content of the cell at the specified
+   *          linear index. The digit is assumed to be in the
+   *          range `[0; 9]`.
+   * @param id - the linear index of the cell.
+   * @param digit - the digit to store.
+   * @param kind - the kind of the digit.
+   */
+  void set(unsigned id, unsigned digit, const DigitKind &kind) noexcept;
+
+  /**
+   * @brief - Generate the metadata describing this board: the
+   *          level and last played time are provided as input.
+   * @param level - the difficulty level of the game.
+   * @param lastPlayed - the last time the game was played in
+   *                     seconds since the epoch.
+   * @return - the metadata for this board.
+   */
+  SaveMetadata metadata(const Level &level,
+                        std::int64_t lastPlayed) const noexcept;
+
+  /**
+   * @brief - Write the packed representation, preceded by a
+   *          small header identifying the format and by the
+   *          metadata, to the input stream in a single write.
+   * @param out - the stream to write to.
+   * @param metadata - the metadata to write in the header.
+   */
+  void save(std::ostream &out, const SaveMetadata &metadata) const;
+
+  /**
+   * @brief - Read a packed representation from the input stream
+   *          as written by `save`. In case the header does not
+   *          match the expected format the stream is restored at
+   *          its initial position and `false` is returned.
+   * @param in - the stream to read from.
+   * @param metadata - optional output argument receiving the
+   *                   metadata saved with the board.
+   * @return - `true` if the board could be read.
+   */
+  bool load(std::istream &in, SaveMetadata *metadata = nullptr);
+
+  /**
+   * @brief - Read only the metadata from the input stream. This
+   *          only reads the first few bytes of the stream.
+   * @param in - the stream to read from.
+   * @param metadata - output argument receiving the metadata.
+   * @return - `true` if the metadata could be read.
+   */
+  static bool readMetadata(std::istream &in, SaveMetadata &metadata);
+
+  bool operator==(const PackedBoard &rhs) const noexcept;
+
+  bool operator!=(const PackedBoard &rhs) const noexcept;
+
+private:
+  /**
+   * @brief - The digits (two per byte) followed by the kinds
+   *          (four per byte) of each cell.
+   */
+  std::array<std::uint8_t, bytes> m_data;
+};
+
+} // namespace sudoku
+
+#endif /* PACKED_BOARD_HH */
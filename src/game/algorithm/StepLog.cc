@@ -0,0 +1,59 @@
+
+#include "StepLog.hh"
+
+namespace sudoku::algorithm {
+namespace {
+
+/// @brief - The number of steps held by a chunk.
+constexpr std::size_t chunkBits = 16u;
+constexpr std::size_t chunkSize = 1u << chunkBits;
+
+/// @brief - The masks to unpack a step.
+constexpr std::uint16_t cellMask = 0x7Fu;
+constexpr std::uint16_t digitMask = 0xFu;
+
+} // namespace
+
+StepLog::StepLog() noexcept
+    : m_chunks(), m_cursor(nullptr), m_end(nullptr), m_truncated(false) {}
+
+std::size_t StepLog::size() const noexcept {
+  if (m_chunks.empty()) {
+    return 0u;
+  }
+
+  return (m_chunks.size() - 1u) * chunkSize +
+         static_cast<std::size_t>(m_cursor - m_chunks.back().get());
+}
+
+bool StepLog::truncated() const noexcept { return m_truncated; }
+
+StepLog::Step StepLog::at(std::size_t id) const noexcept {
+  std::uint16_t step = m_chunks[id >> chunkBits][id & (chunkSize - 1u)];
+
+  return Step{static_cast<unsigned>(step & cellMask),
+              static_cast<unsigned>((step >> digitShift) & digitMask),
+              (step & backtrackBit) != 0u};
+}
+
+void StepLog::clear() noexcept {
+  m_chunks.clear();
+  m_cursor = nullptr;
+  m_end = nullptr;
+  m_truncated = false;
+}
+
+void StepLog::grow() {
+  if (m_chunks.size() * chunkSize >= maxSteps) {
+    m_truncated = true;
+    return;
+  }
+
+  // The chunk is not initialized: only the recorded steps are
+  // ever read.
+  m_chunks.emplace_back(new std::uint16_t[chunkSize]);
+  m_cursor = m_chunks.back().get();
+  m_end = m_cursor + chunkSize;
+}
+
+} // namespace sudoku::algorithm
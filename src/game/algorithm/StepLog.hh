@@ -0,0 +1,128 @@
+#ifndef STEP_LOG_HH
+#define STEP_LOG_HH
+
+#include "Definitions.hh"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sudoku::algorithm {
+
+/// @brief - Records the placements and backtracks performed by a
+/// solver so that the search can be replayed. Each step is packed
+/// in 16 bits: the cell in the lowest 7 bits, the digit in the 4
+/// next ones and whether it is a backtrack in the bit above. Steps
+/// are stored in fixed size chunks so that recording never copies
+/// the steps already recorded, and appending a step usually costs
+/// a single store.
+class StepLog {
+public:
+  /// @brief - A step of the search, as unpacked from the log.
+  struct Step {
+    // The linear index of the cell.
+    unsigned cell;
+
+    // The digit put in the cell or removed from it.
+    unsigned digit;
+
+    // Whether the digit was removed from the cell.
+    bool backtrack;
+  };
+
+  /// @brief - The maximum number of steps kept in the log: further
+  /// steps are dropped so that the memory used stays bounded (32MB
+  /// at most).
+  static constexpr std::size_t maxSteps = 1u << 24u;
+
+  /**
+   * @brief - Create an empty log.
+   */
+  StepLog() noexcept;
+
+  /**
+   * @brief - Record that a digit was put in a cell.
+   * @param cell - the linear index of the cell.
+   * @param digit - the digit put in the cell.
+   */
+  void place(unsigned cell, unsigned digit) {
+    push(static_cast<std::uint16_t>(cell | (digit << digitShift)));
+  }
+
+  /**
+   * @brief - Record that a digit was removed from a cell because
+   *          it led to a dead end.
+   * @param cell - the linear index of the cell.
+   * @param digit - the digit removed from the cell.
+   */
+  void backtrack(unsigned cell, unsigned digit) {
+    push(static_cast<std::uint16_t>(cell | (digit << digitShift) |
+                                    backtrackBit));
+  }
+
+  /**
+   * @brief - The number of steps recorded.
+   * @return - the size of the log.
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief - Whether steps were dropped because the log was full.
+   * @return - `true` if the log is incomplete.
+   */
+  bool truncated() const noexcept;
+
+  /**
+   * @brief - Unpack the step at the input index.
+   * @param id - the index of the step, must be lower than `size`.
+   * @return - the step.
+   */
+  Step at(std::size_t id) const noexcept;
+
+  /**
+   * @brief - Remove all the steps from the log.
+   */
+  void clear() noexcept;
+
+private:
+  /// @brief - The layout of a packed step.
+  static constexpr unsigned digitShift = 7u;
+  static constexpr std::uint16_t backtrackBit = 1u << 11u;
+
+  /**
+   * @brief - Append a packed step to the log.
+   * @param step - the step to append.
+   */
+  void push(std::uint16_t step) {
+    if (m_cursor == m_end) {
+      grow();
+    }
+    if (m_cursor != m_end) {
+      *m_cursor++ = step;
+    }
+  }
+
+  /**
+   * @brief - Allocate a new chunk once the last one is full, or
+   *          mark the log as truncated when it reached its maximum
+   *          size.
+   */
+  void grow();
+
+private:
+  /// @brief - The chunks holding the steps: all of them are full
+  /// except the last one.
+  std::vector<std::unique_ptr<std::uint16_t[]>> m_chunks;
+
+  /// @brief - The position of the next step in the last chunk and
+  /// the end of this chunk.
+  std::uint16_t *m_cursor;
+  std::uint16_t *m_end;
+
+  /// @brief - Whether steps were dropped.
+  bool m_truncated;
+};
+
+} // namespace sudoku::algorithm
+
+#endif /* STEP_LOG_HH */
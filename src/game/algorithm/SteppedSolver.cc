@@ -0,0 +1,129 @@
+
+#include "SteppedSolver.hh"
+
+namespace sudoku::algorithm {
+namespace {
+
+/// @brief - The clock is only checked each time the number of
+/// steps performed is a multiple of 64: reading it costs more
+/// than a step.
+constexpr unsigned clockMask = 63u;
+
+} // namespace
+
+SteppedSolver::SteppedSolver() noexcept
+    : m_grid(), m_stack(), m_depth(0u), m_state(State::Unsolvable),
+      m_nodes(0u), m_duration(0.0f), m_log(nullptr) {}
+
+bool SteppedSolver::load(const Grid &grid) noexcept {
+  m_depth = 0u;
+  m_state = State::Running;
+  m_nodes = 0u;
+  m_duration = 0.0f;
+
+  if (!m_grid.load(grid)) {
+    m_state = State::Unsolvable;
+    return false;
+  }
+
+  if (m_grid.empty() == 0u) {
+    m_state = State::Solved;
+    return true;
+  }
+
+  descend();
+  if (m_depth == 0u) {
+    m_state = State::Unsolvable;
+  }
+
+  return true;
+}
+
+SteppedSolver::State
+SteppedSolver::resume(const std::chrono::microseconds &budget) noexcept {
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point end = start + budget;
+
+  unsigned steps = 0u;
+  while (m_state == State::Running) {
+    advance();
+
+    ++steps;
+    if ((steps & clockMask) == 0u && std::chrono::steady_clock::now() >= end) {
+      break;
+    }
+  }
+
+  std::chrono::duration<float, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  m_duration += elapsed.count();
+
+  return m_state;
+}
+
+SteppedSolver::State SteppedSolver::state() const noexcept { return m_state; }
+
+const Grid &SteppedSolver::grid() const noexcept { return m_grid.grid(); }
+
+unsigned SteppedSolver::nodes() const noexcept { return m_nodes; }
+
+float SteppedSolver::duration() const noexcept { return m_duration; }
+
+void SteppedSolver::record(StepLog *log) noexcept { m_log = log; }
+
+void SteppedSolver::advance() noexcept {
+  Frame &frame = m_stack[m_depth - 1u];
+
+  // Revert the candidate tried last for this cell, if any.
+  unsigned previous = m_grid.at(frame.cell);
+  if (previous != 0u) {
+    m_grid.assign(frame.cell, 0u);
+
+    if (m_log != nullptr) {
+      m_log->backtrack(frame.cell, previous);
+    }
+  }
+
+  if (frame.remaining == 0u) {
+    --m_depth;
+    if (m_depth == 0u) {
+      m_state = State::Unsolvable;
+    }
+
+    return;
+  }
+
+  unsigned digit = __builtin_ctz(frame.remaining) + 1u;
+  frame.remaining &= frame.remaining - 1u;
+
+  m_grid.assign(frame.cell, digit);
+  ++m_nodes;
+
+  if (m_log != nullptr) {
+    m_log->place(frame.cell, digit);
+  }
+
+  if (m_grid.empty() == 0u) {
+    m_state = State::Solved;
+    return;
+  }
+
+  // When a cell has no candidates left nothing is pushed: the
+  // next step tries another candidate for this cell.
+  descend();
+}
+
+void SteppedSolver::descend() noexcept {
+  unsigned best = counting::cellsCount;
+  std::uint16_t bestMask = 0u;
+
+  if (m_grid.pick(best, bestMask) == 0u) {
+    return;
+  }
+
+  m_stack[m_depth] = Frame{best, bestMask};
+  ++m_depth;
+}
+
+} // namespace sudoku::algorithm
@@ -0,0 +1,118 @@
+#ifndef STEPPED_SOLVER_HH
+#define STEPPED_SOLVER_HH
+
+#include "CandidateSolver.hh"
+#include <chrono>
+
+namespace sudoku::algorithm {
+
+/// @brief - A backtracking solver which can be interrupted and
+/// resumed: the search is driven by an explicit stack kept between
+/// calls instead of the call stack. This allows to spread a long
+/// search over several frames on machines where a thread can't be
+/// spared for it. It shares its grid and heuristic with
+/// `CandidateSolver` but only looks for the first solution.
+class SteppedSolver {
+public:
+  /// @brief - The state of the search.
+  enum class State { Running, Solved, Unsolvable };
+
+  /**
+   * @brief - Create a new solver with an empty grid.
+   */
+  SteppedSolver() noexcept;
+
+  /**
+   * @brief - Reset the solver with the digits of the input grid.
+   *          The search starts with the next call to `resume`.
+   * @param grid - the puzzle to solve.
+   * @return - `false` if the digits of the grid conflict with each
+   *           other, in which case the puzzle is unsolvable.
+   */
+  bool load(const Grid &grid) noexcept;
+
+  /**
+   * @brief - Continue the search where the last call left it, for
+   *          at most the input duration.
+   * @param budget - the time allocated to the search.
+   * @return - the state of the search when returning.
+   */
+  State resume(const std::chrono::microseconds &budget) noexcept;
+
+  /**
+   * @brief - The state of the search.
+   * @return - the state of the search.
+   */
+  State state() const noexcept;
+
+  /**
+   * @brief - The digits assigned so far: this is the solution once
+   *          the search is over and succeeded.
+   * @return - the current grid.
+   */
+  const Grid &grid() const noexcept;
+
+  /**
+   * @brief - The number of cells assigned since the last `load`.
+   * @return - the number of nodes explored.
+   */
+  unsigned nodes() const noexcept;
+
+  /**
+   * @brief - The time spent in `resume` since the last `load`.
+   * @return - the duration in milliseconds.
+   */
+  float duration() const noexcept;
+
+  /**
+   * @brief - Attach a log to record the placements and backtracks
+   *          of the next searches into.
+   * @param log - the log to append the steps to, or `null` to stop
+   *              recording.
+   */
+  void record(StepLog *log) noexcept;
+
+private:
+  /// @brief - A level of the explicit stack: the cell being filled
+  /// and the candidates which were not tried yet.
+  struct Frame {
+    unsigned cell;
+    std::uint16_t remaining;
+  };
+
+  /**
+   * @brief - Perform a single step of the search: try the next
+   *          candidate of the deepest cell or backtrack if none
+   *          are left.
+   */
+  void advance() noexcept;
+
+  /**
+   * @brief - Push the empty cell with the fewest candidates on the
+   *          stack. Nothing is pushed if a cell has no candidates.
+   */
+  void descend() noexcept;
+
+private:
+  /// @brief - The current state of the grid during the search.
+  CandidateGrid m_grid;
+
+  /// @brief - The explicit stack of the search: there is at most
+  /// one level per cell.
+  std::array<Frame, counting::cellsCount> m_stack;
+  unsigned m_depth;
+
+  /// @brief - The state of the search.
+  State m_state;
+
+  /// @brief - Statistics about the search.
+  unsigned m_nodes;
+  float m_duration;
+
+  /// @brief - The log recording the steps of the search, if any.
+  StepLog *m_log;
+};
+
+} // namespace sudoku::algorithm
+
+#endif /* STEPPED_SOLVER_HH */
@@ -1,7 +1,7 @@
 
 # include "SudokuMatrix.hh"
-# include <fstream>
 # include <limits>
+# include "Allocations.hh"
 # include "Definitions.hh"
 
 // https://gieseanw.wordpress.com/2011/06/16/solving-sudoku-revisited/
@@ -10,22 +10,6 @@
 
 namespace sudoku::algorithm {
   namespace {
-    void
-    print(const std::vector<int>& matrix, const std::string& fileName) noexcept {
-      if (matrix.empty()) {
-        return;
-      }
-
-      std::ofstream out(fileName);
-
-      for (int row = 0u ; row < counting::choices ; ++row) {
-        for (int column = 0u ; column < counting::constraints ; ++column) {
-          out << matrix[row * counting::constraints + column];
-        }
-        out << std::endl;
-      }
-    }
-
     bool
     initializeMatrix(std::vector<int>& matrix) noexcept {
       if (matrix.size() != counting::choices * counting::constraints) {
@@ -240,6 +224,7 @@ namespace sudoku::algorithm {
 
   std::stack<MatrixNode>
   SudokuMatrix::solve(const Board& board) {
+    allocations::Scope allocs(allocations::Category::Solve);
     m_solved = false;
 
     Solver helper = initializePuzzle(board);
@@ -267,7 +252,6 @@ namespace sudoku::algorithm {
       error("Failed to initialize Sudoku matrix");
     }
 
-    print(m_matrix, "matrix.txt");
     verifyMatrix();
   }
 
@@ -355,9 +339,12 @@ namespace sudoku::algorithm {
       error("Failed to pick a column while " + std::to_string(helper.columns.size()) + " are available");
     }
 
+    // A constraint which no row satisfies anymore means that the
+    // digits picked so far lead to a dead end.
     int row = helper.chooseRow(m_matrix, column);
     if (row < 0) {
-      error("Failed to pick a row while " + std::to_string(helper.rows.size()) + " are available");
+      verbose("No row satisfies constraint " + std::to_string(column + 1) + " while " + std::to_string(helper.rows.size()) + " are available");
+      return false;
     }
 
     verbose("Picked constraint " + std::to_string(column + 1) + "x" + std::to_string(row + 1));
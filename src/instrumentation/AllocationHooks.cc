@@ -0,0 +1,54 @@
+
+#include "Allocations.hh"
+#include <cstdlib>
+#include <new>
+
+// Replacement of the global allocation functions feeding the
+// counters of `Allocations.hh`. It is built as a separate object
+// library linked by the executables which display the counters,
+// so that `sudoku_core` doesn't impose it on the programs using
+// the library.
+
+namespace {
+
+void *allocate(std::size_t size) {
+  sudoku::allocations::count(size);
+
+  if (size == 0u) {
+    size = 1u;
+  }
+
+  // As required for `operator new`, give the new handler a chance
+  // to release some memory before failing.
+  while (true) {
+    void *ptr = std::malloc(size);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    handler();
+  }
+}
+
+} // namespace
+
+void *operator new(std::size_t size) { return allocate(size); }
+
+void *operator new[](std::size_t size) { return allocate(size); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
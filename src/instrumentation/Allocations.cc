@@ -0,0 +1,74 @@
+
+#include "Allocations.hh"
+#include <atomic>
+
+namespace sudoku::allocations {
+namespace {
+
+/// @brief - The counters of a category. Aligned so that threads
+/// updating different categories do not share a cache line.
+struct alignas(64) Counters {
+  std::atomic<std::uint64_t> count;
+  std::atomic<std::uint64_t> bytes;
+};
+
+std::atomic<bool> active(false);
+
+Counters totalCounters;
+Counters categoryCounters[categoriesCount];
+
+thread_local Category current = Category::Other;
+
+Counts load(const Counters &c) noexcept {
+  return Counts{c.count.load(std::memory_order_relaxed),
+                c.bytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace
+
+void enable(bool enabled) noexcept {
+  active.store(enabled, std::memory_order_relaxed);
+}
+
+bool enabled() noexcept { return active.load(std::memory_order_relaxed); }
+
+void count(std::size_t size) noexcept {
+  if (!active.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  Counters &c = categoryCounters[static_cast<unsigned>(current)];
+
+  totalCounters.count.fetch_add(1u, std::memory_order_relaxed);
+  totalCounters.bytes.fetch_add(size, std::memory_order_relaxed);
+  c.count.fetch_add(1u, std::memory_order_relaxed);
+  c.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+Counts total() noexcept { return load(totalCounters); }
+
+Counts of(const Category &category) noexcept {
+  return load(categoryCounters[static_cast<unsigned>(category)]);
+}
+
+const char *name(const Category &category) noexcept {
+  switch (category) {
+  case Category::Frame:
+    return "frame";
+  case Category::Solve:
+    return "solve";
+  case Category::Generate:
+    return "generate";
+  case Category::Other:
+  default:
+    return "other";
+  }
+}
+
+Scope::Scope(const Category &category) noexcept : m_previous(current) {
+  current = category;
+}
+
+Scope::~Scope() { current = m_previous; }
+
+} // namespace sudoku::allocations
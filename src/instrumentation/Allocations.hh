@@ -0,0 +1,100 @@
+#ifndef ALLOCATIONS_HH
+#define ALLOCATIONS_HH
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sudoku::allocations {
+
+/// @brief - The parts of the program to which the allocations are
+/// attributed. An allocation is attributed to the innermost scope
+/// active on the calling thread, and to `Other` outside of them.
+enum class Category { Other, Frame, Solve, Generate };
+
+/// @brief - The number of categories.
+constexpr unsigned categoriesCount = 4u;
+
+/// @brief - The dynamic allocations performed while counting was
+/// enabled. The counters are maintained by the replacement of the
+/// global `operator new`, which is only linked in the executables
+/// which display them: they stay at zero elsewhere.
+struct Counts {
+  // The number of calls to `operator new`.
+  std::uint64_t count{0u};
+
+  // The total number of bytes requested.
+  std::uint64_t bytes{0u};
+};
+
+/**
+ * @brief - Enable or disable the counting of allocations. Counting is
+ *          disabled by default: allocations then only pay for a check
+ *          of this flag.
+ * @param enabled - `true` to count allocations.
+ */
+void enable(bool enabled) noexcept;
+
+/**
+ * @brief - Whether allocations are currently counted.
+ * @return - `true` if allocations are counted.
+ */
+bool enabled() noexcept;
+
+/**
+ * @brief - Attribute an allocation to the category active on the
+ *          calling thread. Called by the replacement of the global
+ *          `operator new`: it should not allocate.
+ * @param size - the number of bytes requested.
+ */
+void count(std::size_t size) noexcept;
+
+/**
+ * @brief - The allocations performed by all the threads.
+ * @return - the allocations counted so far.
+ */
+Counts total() noexcept;
+
+/**
+ * @brief - The allocations attributed to the input category.
+ * @param category - the category to fetch.
+ * @return - the allocations counted so far for the category.
+ */
+Counts of(const Category &category) noexcept;
+
+/**
+ * @brief - A short name for the category, used when displaying the
+ *          counters.
+ * @param category - the category.
+ * @return - the name of the category.
+ */
+const char *name(const Category &category) noexcept;
+
+/// @brief - Attributes the allocations performed by the calling
+/// thread to a category from its creation to its destruction:
+///   sudoku::allocations::Scope scope(Category::Solve);
+class Scope {
+public:
+  /**
+   * @brief - Make the input category the active one for the thread.
+   * @param category - the category of the allocations.
+   */
+  Scope(const Category &category) noexcept;
+
+  /**
+   * @brief - Restore the category active before this scope.
+   */
+  ~Scope();
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+private:
+  /**
+   * @brief - The category active when the scope was created.
+   */
+  Category m_previous;
+};
+
+} // namespace sudoku::allocations
+
+#endif /* ALLOCATIONS_HH */
@@ -0,0 +1,258 @@
+
+#include "Metrics.hh"
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+
+namespace sudoku::metrics {
+namespace {
+
+std::string format(double value) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.9g", value);
+
+  return buf;
+}
+
+/// @brief - Build the label set of a sample from the labels of the
+/// metric and the additional label of the sample (if any).
+std::string labelSet(const std::string &labels, const std::string &extra) {
+  std::string all = labels;
+  if (!extra.empty()) {
+    all += (all.empty() ? "" : ",") + extra;
+  }
+
+  return (all.empty() ? "" : "{" + all + "}");
+}
+
+} // namespace
+
+Counter::Counter() noexcept : m_value(0u) {}
+
+void Counter::increment(std::uint64_t value) noexcept {
+  m_value.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t Counter::value() const noexcept {
+  return m_value.load(std::memory_order_relaxed);
+}
+
+Histogram::Histogram(const std::vector<double> &bounds)
+    : m_bounds(bounds),
+      m_buckets(new std::atomic<std::uint64_t>[bounds.size() + 1u]),
+      m_count(0u), m_sum(0.0) {
+  for (unsigned id = 0u; id <= m_bounds.size(); ++id) {
+    m_buckets[id].store(0u);
+  }
+}
+
+void Histogram::observe(double value) noexcept {
+  unsigned id = 0u;
+  while (id < m_bounds.size() && value > m_bounds[id]) {
+    ++id;
+  }
+
+  m_buckets[id].fetch_add(1u, std::memory_order_relaxed);
+  m_count.fetch_add(1u, std::memory_order_relaxed);
+
+  double sum = m_sum.load(std::memory_order_relaxed);
+  while (!m_sum.compare_exchange_weak(sum, sum + value,
+                                      std::memory_order_relaxed)) {
+    // `sum` is updated with the current value on failure.
+  }
+}
+
+const std::vector<double> &Histogram::bounds() const noexcept {
+  return m_bounds;
+}
+
+std::vector<std::uint64_t> Histogram::buckets() const {
+  std::vector<std::uint64_t> out(m_bounds.size() + 1u);
+  for (unsigned id = 0u; id < out.size(); ++id) {
+    out[id] = m_buckets[id].load(std::memory_order_relaxed);
+  }
+
+  return out;
+}
+
+std::uint64_t Histogram::count() const noexcept {
+  return m_count.load(std::memory_order_relaxed);
+}
+
+double Histogram::sum() const noexcept {
+  return m_sum.load(std::memory_order_relaxed);
+}
+
+std::vector<double> exponentialBounds(double start, double factor,
+                                      unsigned count) {
+  std::vector<double> out;
+  double bound = start;
+
+  for (unsigned id = 0u; id < count; ++id) {
+    out.push_back(bound);
+    bound *= factor;
+  }
+
+  return out;
+}
+
+Timer::Timer(Histogram &histogram) noexcept
+    : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+
+Timer::~Timer() {
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - m_start;
+  m_histogram.observe(elapsed.count());
+}
+
+Registry::Registry()
+    : m_locker(), m_families(), m_flusher(), m_waiter(), m_flushing(false) {}
+
+Registry::~Registry() { stopFlushing(); }
+
+Counter &Registry::counter(const std::string &name, const std::string &help,
+                           const std::string &labels) {
+  const std::lock_guard<std::mutex> guard(m_locker);
+
+  std::unique_ptr<Counter> &c =
+      family(name, help, Kind::Counter).counters[labels];
+  if (c == nullptr) {
+    c = std::make_unique<Counter>();
+  }
+
+  return *c;
+}
+
+Histogram &Registry::histogram(const std::string &name,
+                               const std::string &help,
+                               const std::vector<double> &bounds,
+                               const std::string &labels) {
+  const std::lock_guard<std::mutex> guard(m_locker);
+
+  std::unique_ptr<Histogram> &h =
+      family(name, help, Kind::Histogram).histograms[labels];
+  if (h == nullptr) {
+    h = std::make_unique<Histogram>(bounds);
+  }
+
+  return *h;
+}
+
+void Registry::write(std::ostream &out) const {
+  const std::lock_guard<std::mutex> guard(m_locker);
+
+  for (const auto &f : m_families) {
+    const std::string &name = f.first;
+    const Family &family = f.second;
+
+    out << "# HELP " << name << " " << family.help << '\n';
+    out << "# TYPE " << name << " "
+        << (family.kind == Kind::Counter ? "counter" : "histogram") << '\n';
+
+    for (const auto &c : family.counters) {
+      out << name << labelSet(c.first, "") << " " << c.second->value()
+          << '\n';
+    }
+
+    for (const auto &h : family.histograms) {
+      const Histogram &histogram = *h.second;
+      std::vector<std::uint64_t> buckets = histogram.buckets();
+
+      // Buckets are cumulative in the exposition format.
+      std::uint64_t total = 0u;
+      for (unsigned id = 0u; id < buckets.size(); ++id) {
+        total += buckets[id];
+
+        std::string bound = (id < histogram.bounds().size()
+                                 ? format(histogram.bounds()[id])
+                                 : std::string("+Inf"));
+
+        out << name << "_bucket"
+            << labelSet(h.first, "le=\"" + bound + "\"") << " " << total
+            << '\n';
+      }
+
+      out << name << "_sum" << labelSet(h.first, "") << " "
+          << format(histogram.sum()) << '\n';
+      out << name << "_count" << labelSet(h.first, "") << " " << total
+          << '\n';
+    }
+  }
+}
+
+bool Registry::flush(const std::string &file) const {
+  std::string tmp = file + ".tmp";
+
+  {
+    std::ofstream out(tmp.c_str(), std::ios::trunc);
+    if (!out.good()) {
+      return false;
+    }
+
+    write(out);
+    out.flush();
+
+    if (!out.good()) {
+      return false;
+    }
+  }
+
+  return std::rename(tmp.c_str(), file.c_str()) == 0;
+}
+
+void Registry::startFlushing(const std::string &file, unsigned periodMs) {
+  stopFlushing();
+
+  const std::lock_guard<std::mutex> guard(m_locker);
+  m_flushing = true;
+  m_flusher = std::thread(&Registry::flushLoop, this, file, periodMs);
+}
+
+void Registry::stopFlushing() {
+  std::thread flusher;
+  {
+    const std::lock_guard<std::mutex> guard(m_locker);
+    m_flushing = false;
+    std::swap(flusher, m_flusher);
+  }
+
+  m_waiter.notify_all();
+  if (flusher.joinable()) {
+    flusher.join();
+  }
+}
+
+Registry::Family &Registry::family(const std::string &name,
+                                   const std::string &help,
+                                   const Kind &kind) {
+  auto it = m_families.find(name);
+  if (it == m_families.end()) {
+    it = m_families.emplace(name, Family{kind, help, {}, {}}).first;
+  }
+
+  return it->second;
+}
+
+void Registry::flushLoop(std::string file, unsigned periodMs) {
+  bool running = true;
+
+  while (running) {
+    {
+      std::unique_lock<std::mutex> lock(m_locker);
+      running = !m_waiter.wait_for(lock, std::chrono::milliseconds(periodMs),
+                                   [this]() { return !m_flushing; });
+    }
+
+    // Flush without holding the lock: `write` acquires it.
+    flush(file);
+  }
+}
+
+Registry &registry() {
+  // Never destroyed: metrics might still be updated while the
+  // program exits.
+  static Registry *registry = new Registry();
+  return *registry;
+}
+
+} // namespace sudoku::metrics
@@ -0,0 +1,284 @@
+#ifndef METRICS_HH
+#define METRICS_HH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sudoku::metrics {
+
+/// @brief - A value which can only increase, such as a number of
+/// events. Updates are lock-free.
+class Counter {
+public:
+  /**
+   * @brief - Create a counter starting at zero.
+   */
+  Counter() noexcept;
+
+  /**
+   * @brief - Increase the value of the counter.
+   * @param value - the amount to add.
+   */
+  void increment(std::uint64_t value = 1u) noexcept;
+
+  /**
+   * @brief - The current value of the counter.
+   * @return - the value of the counter.
+   */
+  std::uint64_t value() const noexcept;
+
+private:
+  /**
+   * @brief - The value of the counter.
+   */
+  std::atomic<std::uint64_t> m_value;
+};
+
+/// @brief - Aggregates a distribution of values (typically durations
+/// in seconds) into buckets with fixed upper bounds. Updates are
+/// lock-free so that observing a value is cheap enough to be done
+/// on each frame.
+class Histogram {
+public:
+  /**
+   * @brief - Create a histogram with the specified upper bounds for
+   *          its buckets: an additional bucket catches the values
+   *          larger than the last bound.
+   * @param bounds - the upper bounds of the buckets in increasing
+   *                 order.
+   */
+  Histogram(const std::vector<double> &bounds);
+
+  /**
+   * @brief - Register a new value in the distribution.
+   * @param value - the value to register.
+   */
+  void observe(double value) noexcept;
+
+  /**
+   * @brief - The upper bounds of the buckets.
+   * @return - the bounds (without the implicit infinite one).
+   */
+  const std::vector<double> &bounds() const noexcept;
+
+  /**
+   * @brief - The number of values in each bucket (not cumulated).
+   *          The last entry corresponds to the values larger than
+   *          all the bounds.
+   * @return - the number of values per bucket.
+   */
+  std::vector<std::uint64_t> buckets() const;
+
+  /**
+   * @brief - The number of values registered.
+   * @return - the number of values.
+   */
+  std::uint64_t count() const noexcept;
+
+  /**
+   * @brief - The sum of the values registered.
+   * @return - the sum of the values.
+   */
+  double sum() const noexcept;
+
+private:
+  /**
+   * @brief - The upper bounds of the buckets.
+   */
+  std::vector<double> m_bounds;
+
+  /**
+   * @brief - The number of values in each bucket, with one more
+   *          bucket than bounds.
+   */
+  std::unique_ptr<std::atomic<std::uint64_t>[]> m_buckets;
+
+  /**
+   * @brief - The number of values and their sum.
+   */
+  std::atomic<std::uint64_t> m_count;
+  std::atomic<double> m_sum;
+};
+
+/**
+ * @brief - Generate bounds growing geometrically, suited to measure
+ *          durations spanning several orders of magnitude.
+ * @param start - the first bound.
+ * @param factor - the ratio between two consecutive bounds.
+ * @param count - the number of bounds.
+ * @return - the bounds.
+ */
+std::vector<double> exponentialBounds(double start, double factor,
+                                      unsigned count);
+
+/// @brief - Records the time elapsed between its creation and its
+/// destruction in seconds in a histogram.
+class Timer {
+public:
+  /**
+   * @brief - Start measuring.
+   * @param histogram - the histogram receiving the duration.
+   */
+  Timer(Histogram &histogram) noexcept;
+
+  /**
+   * @brief - Register the elapsed time in the histogram.
+   */
+  ~Timer();
+
+  Timer(const Timer &) = delete;
+  Timer &operator=(const Timer &) = delete;
+
+private:
+  /**
+   * @brief - The histogram receiving the duration.
+   */
+  Histogram &m_histogram;
+
+  /**
+   * @brief - The time at which the measure started.
+   */
+  std::chrono::steady_clock::time_point m_start;
+};
+
+/// @brief - Holds all the counters and histograms of the program and
+/// exports them in the Prometheus text exposition format. Metrics
+/// are identified by their name and their labels (for example
+/// `level="easy"`): requesting the same metric twice returns the
+/// same object. Looking up a metric takes a lock so callers should
+/// keep a reference to it rather than requesting it on each update.
+class Registry {
+public:
+  /**
+   * @brief - Create an empty registry.
+   */
+  Registry();
+
+  /**
+   * @brief - Stop the periodic flush if any.
+   */
+  ~Registry();
+
+  /**
+   * @brief - Fetch or create a counter.
+   * @param name - the name of the metric.
+   * @param help - the description of the metric.
+   * @param labels - the labels identifying the counter within the
+   *                 metric, in the exposition format.
+   * @return - the counter.
+   */
+  Counter &counter(const std::string &name, const std::string &help,
+                   const std::string &labels = "");
+
+  /**
+   * @brief - Fetch or create a histogram. The bounds are only used
+   *          when the histogram is created.
+   * @param name - the name of the metric.
+   * @param help - the description of the metric.
+   * @param bounds - the upper bounds of the buckets.
+   * @param labels - the labels identifying the histogram within the
+   *                 metric, in the exposition format.
+   * @return - the histogram.
+   */
+  Histogram &histogram(const std::string &name, const std::string &help,
+                       const std::vector<double> &bounds,
+                       const std::string &labels = "");
+
+  /**
+   * @brief - Write all the metrics in the Prometheus text exposition
+   *          format.
+   * @param out - the stream to write to.
+   */
+  void write(std::ostream &out) const;
+
+  /**
+   * @brief - Write all the metrics to the input file. The content is
+   *          written to a temporary file first and then renamed so
+   *          that a scraper never reads a partial file.
+   * @param file - the file to write to.
+   * @return - `true` if the file could be written.
+   */
+  bool flush(const std::string &file) const;
+
+  /**
+   * @brief - Start a thread flushing the metrics to the input file
+   *          at regular intervals, replacing any previous one. The
+   *          metrics are flushed a last time when it stops.
+   * @param file - the file to write to.
+   * @param periodMs - the interval between two flushes.
+   */
+  void startFlushing(const std::string &file, unsigned periodMs);
+
+  /**
+   * @brief - Stop the thread flushing the metrics if any.
+   */
+  void stopFlushing();
+
+private:
+  /// @brief - The kind of a metric.
+  enum class Kind { Counter, Histogram };
+
+  /// @brief - All the counters or histograms sharing a name.
+  struct Family {
+    Kind kind;
+    std::string help;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+  };
+
+  /**
+   * @brief - Fetch or create the family of metrics with the input
+   *          name. Assumes that the lock is held.
+   * @param name - the name of the family.
+   * @param help - the description of the family.
+   * @param kind - the kind of metrics of the family.
+   * @return - the family.
+   */
+  Family &family(const std::string &name, const std::string &help,
+                 const Kind &kind);
+
+  /**
+   * @brief - The main loop of the thread flushing the metrics.
+   * @param file - the file to write to.
+   * @param periodMs - the interval between two flushes.
+   */
+  void flushLoop(std::string file, unsigned periodMs);
+
+private:
+  /**
+   * @brief - Protects the families and the flushing thread.
+   */
+  mutable std::mutex m_locker;
+
+  /**
+   * @brief - The metrics, sorted by name.
+   */
+  std::map<std::string, Family> m_families;
+
+  /**
+   * @brief - The thread flushing the metrics, the condition used to
+   *          wake it up and whether it should keep running.
+   */
+  std::thread m_flusher;
+  std::condition_variable m_waiter;
+  bool m_flushing;
+};
+
+/**
+ * @brief - The registry shared by the whole program.
+ * @return - the registry.
+ */
+Registry &registry();
+
+} // namespace sudoku::metrics
+
+#endif /* METRICS_HH */
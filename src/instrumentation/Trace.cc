@@ -0,0 +1,208 @@
+
+#include "Trace.hh"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sudoku::trace {
+namespace {
+
+/// @brief - The number of events kept for each thread.
+constexpr std::uint64_t bufferCapacity = 16384u;
+
+/// @brief - A single event, as recorded by a thread.
+struct Event {
+  const char *name;
+  const char *category;
+  std::int64_t start;
+  std::int64_t duration;
+};
+
+/// @brief - The events recorded by a thread. Only the owning thread
+/// writes to the buffer: `head` is the number of events recorded so
+/// far and is published after each event is written.
+struct Buffer {
+  unsigned thread;
+  std::string name;
+  std::atomic<std::uint64_t> head;
+  std::array<Event, bufferCapacity> events;
+};
+
+/// @brief - The buffers of all the threads which recorded events.
+/// Buffers are never released so that the events of threads which
+/// already exited can still be dumped.
+struct Registry {
+  std::mutex locker;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+Registry &registry() {
+  // Never destroyed: threads might still record events while the
+  // program exits.
+  static Registry *registry = new Registry();
+  return *registry;
+}
+
+const std::chrono::steady_clock::time_point epoch =
+    std::chrono::steady_clock::now();
+
+std::atomic<bool> active(false);
+
+thread_local Buffer *local = nullptr;
+
+/// @brief - The name of the calling thread, kept until its buffer is
+/// created: threads which never record events don't get one.
+thread_local std::string localName;
+
+Buffer &buffer() {
+  if (local == nullptr) {
+    Registry &r = registry();
+    const std::lock_guard<std::mutex> guard(r.locker);
+
+    auto b = std::make_unique<Buffer>();
+    b->thread = static_cast<unsigned>(r.buffers.size() + 1u);
+    b->name = (localName.empty() ? "thread " + std::to_string(b->thread)
+                                 : localName);
+    b->head.store(0u);
+
+    local = b.get();
+    r.buffers.push_back(std::move(b));
+  }
+
+  return *local;
+}
+
+std::string escape(const std::string &str) {
+  std::string out;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    if (static_cast<unsigned char>(c) >= 0x20u) {
+      out += c;
+    }
+  }
+
+  return out;
+}
+
+std::string toMicroseconds(std::int64_t ns) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.3f", ns / 1000.0);
+
+  return buf;
+}
+
+} // namespace
+
+void enable(bool enabled) noexcept { active.store(enabled); }
+
+bool enabled() noexcept { return active.load(std::memory_order_relaxed); }
+
+std::int64_t now() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+void setThreadName(const std::string &name) {
+  localName = name;
+
+  if (local != nullptr) {
+    const std::lock_guard<std::mutex> guard(registry().locker);
+    local->name = name;
+  }
+}
+
+void record(const char *name, const char *category, std::int64_t start,
+            std::int64_t end) noexcept {
+  if (!enabled()) {
+    return;
+  }
+
+  Buffer *b = local;
+  if (b == nullptr) {
+    try {
+      b = &buffer();
+    } catch (...) {
+      return;
+    }
+  }
+
+  std::uint64_t head = b->head.load(std::memory_order_relaxed);
+  b->events[head % bufferCapacity] = Event{name, category, start, end - start};
+  b->head.store(head + 1u, std::memory_order_release);
+}
+
+bool dump(const std::string &file) {
+  std::ofstream out(file.c_str());
+  if (!out.good()) {
+    return false;
+  }
+
+  out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+  bool first = true;
+  auto separator = [&first]() {
+    const char *sep = (first ? "\n" : ",\n");
+    first = false;
+    return sep;
+  };
+
+  Registry &r = registry();
+  const std::lock_guard<std::mutex> guard(r.locker);
+
+  std::vector<Event> events;
+  for (const std::unique_ptr<Buffer> &b : r.buffers) {
+    out << separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", "
+        << "\"pid\": 1, \"tid\": " << b->thread << ", \"args\": {\"name\": \""
+        << escape(b->name) << "\"}}";
+
+    // The thread keeps recording while its events are copied: the
+    // ones which might have been overwritten during the copy are
+    // discarded. This includes the slot of the event being written
+    // after `last`, which is not published yet.
+    std::uint64_t end = b->head.load(std::memory_order_acquire);
+    std::uint64_t start = (end > bufferCapacity ? end - bufferCapacity : 0u);
+
+    events.clear();
+    for (std::uint64_t id = start; id < end; ++id) {
+      events.push_back(b->events[id % bufferCapacity]);
+    }
+
+    std::uint64_t last = b->head.load(std::memory_order_acquire);
+    std::uint64_t valid =
+        (last + 1u > bufferCapacity ? last + 1u - bufferCapacity : 0u);
+    std::size_t skip = (valid > start ? valid - start : 0u);
+
+    for (std::size_t id = skip; id < events.size(); ++id) {
+      const Event &e = events[id];
+
+      out << separator() << "{\"name\": \"" << e.name << "\", \"cat\": \""
+          << e.category << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+          << b->thread << ", \"ts\": " << toMicroseconds(e.start)
+          << ", \"dur\": " << toMicroseconds(e.duration) << "}";
+    }
+  }
+
+  out << "\n]}\n";
+
+  return out.good();
+}
+
+Scope::Scope(const char *name, const char *category) noexcept
+    : m_name(name), m_category(category),
+      m_start(enabled() ? now() : -1) {}
+
+Scope::~Scope() {
+  if (m_start >= 0) {
+    record(m_name, m_category, m_start, now());
+  }
+}
+
+} // namespace sudoku::trace
@@ -0,0 +1,101 @@
+#ifndef TRACE_HH
+#define TRACE_HH
+
+#include <cstdint>
+#include <string>
+
+namespace sudoku::trace {
+
+/**
+ * @brief - Enable or disable the recording of events. Recording is
+ *          disabled by default so that tools which do not need the
+ *          traces do not pay for them.
+ * @param enabled - `true` to record events.
+ */
+void enable(bool enabled) noexcept;
+
+/**
+ * @brief - Whether events are currently recorded.
+ * @return - `true` if events are recorded.
+ */
+bool enabled() noexcept;
+
+/**
+ * @brief - The current time used to timestamp the events.
+ * @return - the number of nanoseconds since the program started.
+ */
+std::int64_t now() noexcept;
+
+/**
+ * @brief - Define the name displayed for the calling thread in the
+ *          traces. The buffer of the thread is only allocated when
+ *          it records its first event.
+ * @param name - the name of the thread.
+ */
+void setThreadName(const std::string &name);
+
+/**
+ * @brief - Record an event of the calling thread. Events are kept in
+ *          a ring buffer specific to each thread so that recording
+ *          does not need any lock: only the most recent events are
+ *          kept. Nothing is recorded when tracing is disabled.
+ * @param name - the name of the event. It is not copied and should
+ *               be a string literal.
+ * @param category - the category of the event. It is not copied and
+ *                   should be a string literal.
+ * @param start - the start of the event as returned by `now`.
+ * @param end - the end of the event as returned by `now`.
+ */
+void record(const char *name, const char *category, std::int64_t start,
+            std::int64_t end) noexcept;
+
+/**
+ * @brief - Write the events recorded by all the threads to the input
+ *          file in the Chrome trace format. The file can be opened
+ *          with `chrome://tracing` or with Perfetto.
+ * @param file - the file to write to.
+ * @return - `true` if the file could be written.
+ */
+bool dump(const std::string &file);
+
+/// @brief - Records an event lasting from its creation to its
+/// destruction. Typical use is to time a block:
+///   sudoku::trace::Scope scope("generate", "solver");
+class Scope {
+public:
+  /**
+   * @brief - Start the event.
+   * @param name - the name of the event (a string literal).
+   * @param category - the category of the event (a string literal).
+   */
+  Scope(const char *name, const char *category = "app") noexcept;
+
+  /**
+   * @brief - Record the event if tracing was enabled when it started.
+   */
+  ~Scope();
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+private:
+  /**
+   * @brief - The name of the event.
+   */
+  const char *m_name;
+
+  /**
+   * @brief - The category of the event.
+   */
+  const char *m_category;
+
+  /**
+   * @brief - The start of the event or a negative value when tracing
+   *          is disabled.
+   */
+  std::int64_t m_start;
+};
+
+} // namespace sudoku::trace
+
+#endif /* TRACE_HH */
@@ -0,0 +1,121 @@
+
+# include "HitGrid.hh"
+# include <algorithm>
+
+namespace {
+
+  /// @brief - The minimum size of a cell of the grid in pixels.
+  constexpr int minCellSize = 32;
+
+  /// @brief - The maximum number of cells along each axis.
+  constexpr int maxCells = 64;
+
+}
+
+namespace pge {
+  namespace menu {
+
+    HitGrid::HitGrid() noexcept:
+      m_origin(),
+      m_cellSize(minCellSize),
+      m_dims(),
+      m_offsets(),
+      m_entries()
+    {}
+
+    void
+    HitGrid::build(const std::vector<Box>& boxes) {
+      m_dims = olc::vi2d();
+      m_offsets.clear();
+      m_entries.clear();
+
+      // Compute the area covered by the boxes.
+      bool empty = true;
+      olc::vi2d tl, br;
+
+      for (unsigned id = 0u ; id < boxes.size() ; ++id) {
+        const Box& b = boxes[id];
+        if (b.size.x <= 0 || b.size.y <= 0) {
+          continue;
+        }
+
+        olc::vi2d end = b.pos + b.size;
+        if (empty) {
+          tl = b.pos;
+          br = end;
+        }
+
+        tl.x = std::min(tl.x, b.pos.x);
+        tl.y = std::min(tl.y, b.pos.y);
+        br.x = std::max(br.x, end.x);
+        br.y = std::max(br.y, end.y);
+
+        empty = false;
+      }
+
+      if (empty) {
+        return;
+      }
+
+      // Use cells large enough to keep the grid small.
+      olc::vi2d extent = br - tl;
+      m_origin = tl;
+      m_cellSize = std::max(minCellSize, (std::max(extent.x, extent.y) + maxCells - 1) / maxCells);
+      m_dims = (extent + olc::vi2d(m_cellSize - 1, m_cellSize - 1)) / m_cellSize;
+
+      // Count the boxes overlapping each cell, then
+      // convert the counts into offsets and finally
+      // fill the entries.
+      m_offsets.resize(m_dims.x * m_dims.y + 1u, 0u);
+
+      auto visit = [this](const Box& b, auto&& process) {
+        olc::vi2d min = (b.pos - m_origin) / m_cellSize;
+        olc::vi2d max = (b.pos + b.size - olc::vi2d(1, 1) - m_origin) / m_cellSize;
+
+        for (int y = min.y ; y <= max.y ; ++y) {
+          for (int x = min.x ; x <= max.x ; ++x) {
+            process(y * m_dims.x + x);
+          }
+        }
+      };
+
+      for (unsigned id = 0u ; id < boxes.size() ; ++id) {
+        if (boxes[id].size.x > 0 && boxes[id].size.y > 0) {
+          visit(boxes[id], [this](int cell) { ++m_offsets[cell + 1]; });
+        }
+      }
+
+      for (unsigned id = 1u ; id < m_offsets.size() ; ++id) {
+        m_offsets[id] += m_offsets[id - 1u];
+      }
+
+      m_entries.resize(m_offsets.back());
+      std::vector<unsigned> next(m_offsets.begin(), m_offsets.end() - 1);
+
+      for (unsigned id = 0u ; id < boxes.size() ; ++id) {
+        if (boxes[id].size.x > 0 && boxes[id].size.y > 0) {
+          visit(boxes[id], [this, &next, id](int cell) { m_entries[next[cell]++] = id; });
+        }
+      }
+    }
+
+    HitGrid::Range
+    HitGrid::candidates(const olc::vi2d& p) const noexcept {
+      olc::vi2d lp = p - m_origin;
+      if (lp.x < 0 || lp.y < 0 || m_dims.x == 0 || m_dims.y == 0) {
+        return Range{nullptr, nullptr};
+      }
+
+      olc::vi2d c = lp / m_cellSize;
+      if (c.x >= m_dims.x || c.y >= m_dims.y) {
+        return Range{nullptr, nullptr};
+      }
+
+      int cell = c.y * m_dims.x + c.x;
+      const unsigned* data = m_entries.data();
+
+      return Range{data + m_offsets[cell], data + m_offsets[cell + 1]};
+    }
+
+  }
+}
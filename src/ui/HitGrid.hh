@@ -0,0 +1,87 @@
+#ifndef    HIT_GRID_HH
+# define   HIT_GRID_HH
+
+# include <vector>
+# include "olcEngine.hh"
+
+namespace pge {
+  namespace menu {
+
+    /// @brief - An axis aligned rectangle in screen coordinates.
+    struct Box {
+      // The position of the top left corner of the box.
+      olc::vi2d pos;
+
+      // The dimensions of the box.
+      olc::vi2d size;
+    };
+
+    /// @brief - A uniform grid over a set of boxes, allowing to
+    /// find the boxes which may contain a position by looking at
+    /// a single cell instead of testing each box. Each cell lists
+    /// the indices of the boxes overlapping it in increasing order
+    /// and all the lists are stored in a single flat array.
+    class HitGrid {
+      public:
+
+        /// @brief - A range of indices of boxes.
+        struct Range {
+          const unsigned* begin;
+          const unsigned* end;
+        };
+
+        /**
+         * @brief - Create an empty grid.
+         */
+        HitGrid() noexcept;
+
+        /**
+         * @brief - Build the grid from the input boxes: any box
+         *          previously registered is discarded. The index
+         *          of a box is its position in the input vector.
+         * @param boxes - the boxes to register.
+         */
+        void
+        build(const std::vector<Box>& boxes);
+
+        /**
+         * @brief - Return the indices of the boxes overlapping the
+         *          cell containing the input position. Note that
+         *          the boxes are not guaranteed to contain it.
+         * @param p - the position to look up.
+         * @return - the indices of the boxes, in increasing order.
+         */
+        Range
+        candidates(const olc::vi2d& p) const noexcept;
+
+      private:
+
+        /**
+         * @brief - The position of the top left corner of the grid
+         *          and the size of its cells in pixels.
+         */
+        olc::vi2d m_origin;
+        int m_cellSize;
+
+        /**
+         * @brief - The number of cells of the grid along each axis.
+         */
+        olc::vi2d m_dims;
+
+        /**
+         * @brief - For each cell the offset of its first entry in
+         *          the `m_entries` array: the entries of the cell
+         *          `id` span `[m_offsets[id]; m_offsets[id + 1])`.
+         */
+        std::vector<unsigned> m_offsets;
+
+        /**
+         * @brief - The indices of the boxes overlapping each cell.
+         */
+        std::vector<unsigned> m_entries;
+    };
+
+  }
+}
+
+#endif    /* HIT_GRID_HH */
@@ -35,7 +35,13 @@ namespace pge {
     m_parent(parent),
     m_children(),
 
-    m_callback()
+    m_callback(),
+
+    m_revision(0u),
+
+    m_geometry(Geometry{false, olc::vi2d(), false, olc::vi2d(), olc::vi2d(), olc::vi2d(), olc::vf2d()}),
+
+    m_hits(nullptr)
   {
     setService("menu");
 
@@ -79,44 +85,49 @@ namespace pge {
       return res;
     }
 
-    // Make sure that the children get their chance
-    // to process the event.
-    for (unsigned id = 0u ; id < m_children.size() ; ++id) {
-      menu::InputHandle rc = m_children[id]->processUserInput(c, actions);
-
-      res.relevant = res.relevant || rc.relevant;
-      res.selected = res.selected || rc.selected;
+    if (m_hits == nullptr) {
+      m_hits = std::make_unique<Hits>(Hits{false, {}, menu::HitGrid(), nullptr, nullptr});
     }
 
-    // If the mouse is not inside this element, stop
-    // the process here: children still got a chance
-    // to update their state with this event. And no
-    // matter the `used` value, we know that we're
-    // not highlighted anymore at this step if the
-    // following conditions apply: it either mean
-    // that the mouse is not inside this menu or
-    // that a child is more relevant than we are.
+    // Only the menu under the mouse can become
+    // highlighted or selected: the others are not
+    // anymore. As at most one menu is highlighted
+    // and one selected at a time there is no need
+    // to visit the whole tree.
     bool click = (c.buttons[controls::mouse::Left] == controls::ButtonState::Released);
+    Menu* hit = pick(olc::vi2d(c.mPosX, c.mPosY));
 
-    olc::vi2d ap = absolutePosition();
-    if (c.mPosX < ap.x || c.mPosX >= ap.x + m_size.x ||
-        c.mPosY < ap.y || c.mPosY >= ap.y + m_size.y ||
-        res.relevant || res.selected)
-    {
-      m_state.highlighted = false;
-
-      if (res.selected || click) {
-        m_state.selected = false;
+    Menu* old = m_hits->highlighted;
+    if (old != nullptr && old != hit) {
+      if (old->m_state.highlighted) {
+        old->m_state.highlighted = false;
+        old->invalidate();
+      }
+      m_hits->highlighted = nullptr;
+    }
+
+    old = m_hits->selected;
+    if (click && old != nullptr && old != hit) {
+      if (old->m_state.selected) {
+        old->m_state.selected = false;
+        old->invalidate();
       }
+      m_hits->selected = nullptr;
+    }
 
+    if (hit == nullptr) {
       return res;
     }
 
     // This menu is now highlighted. We also set
     // the return value to indicate that this
     // event was indeed relevant.
-    bool process = onHighlight();
-    m_state.highlighted = process;
+    bool process = hit->onHighlight();
+    if (hit->m_state.highlighted != process) {
+      hit->m_state.highlighted = process;
+      hit->invalidate();
+    }
+    m_hits->highlighted = hit;
     res.relevant = true;
 
     // In case the user clicks on the menu, we need
@@ -125,18 +136,79 @@ namespace pge {
       // Only trigger the `onClick` in case the user
       // indicated to do so when building the menu.
       if (process) {
-        onClick(actions);
+        hit->onClick(actions);
       }
 
       // But always register the internal state as
       // selected.
-      m_state.selected = true;
+      if (!hit->m_state.selected) {
+        hit->m_state.selected = true;
+        hit->invalidate();
+      }
+      m_hits->selected = hit;
       res.selected = true;
     }
 
     return res;
   }
 
+  Menu*
+  Menu::pick(const olc::vi2d& p) {
+    // Build the grid again if the layout changed.
+    if (!m_hits->valid) {
+      m_hits->menus.clear();
+      collect(m_hits->menus);
+
+      std::vector<menu::Box> boxes(m_hits->menus.size());
+      for (unsigned id = 0u ; id < m_hits->menus.size() ; ++id) {
+        const Menu* m = m_hits->menus[id];
+        boxes[id] = menu::Box{m->absolutePosition(), m->m_size};
+      }
+
+      m_hits->grid.build(boxes);
+      m_hits->valid = true;
+    }
+
+    // Menus are listed in the order they are rendered
+    // so children come after their parent: the first
+    // visible menu containing the position starting
+    // from the end is the deepest one.
+    menu::HitGrid::Range r = m_hits->grid.candidates(p);
+
+    for (const unsigned* it = r.end ; it != r.begin ; ) {
+      Menu* m = m_hits->menus[*--it];
+
+      olc::vi2d ap = m->absolutePosition();
+      if (p.x < ap.x || p.x >= ap.x + m->m_size.x ||
+          p.y < ap.y || p.y >= ap.y + m->m_size.y)
+      {
+        continue;
+      }
+
+      // The menu must be visible along with all its
+      // parents.
+      bool visible = true;
+      for (const Menu* a = m ; a != this && visible ; a = a->m_parent) {
+        visible = a->m_state.visible;
+      }
+
+      if (visible) {
+        return m;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void
+  Menu::collect(std::vector<Menu*>& menus) {
+    menus.push_back(this);
+
+    for (unsigned id = 0u ; id < m_children.size() ; ++id) {
+      m_children[id]->collect(menus);
+    }
+  }
+
   void
   Menu::addMenu(MenuShPtr child) {
     // Check consistency.
@@ -156,12 +228,14 @@ namespace pge {
     }
 
     child->m_parent = this;
+    child->invalidateLayout();
 
     m_children.push_back(child);
 
     // Update properties of each child in response
     // to the new child.
     updateChildren();
+    invalidate();
   }
 
   void
@@ -178,6 +252,34 @@ namespace pge {
 
   void
   Menu::renderSelf(olc::PixelGameEngine* pge) const {
+    // In case there's no text nor sprite to display
+    // we can return right now.
+    if (m_fg.text == "" && m_fgSprite == nullptr) {
+      return;
+    }
+
+    layoutContent(pge);
+
+    olc::Pixel c = m_fg.color;
+    if ((m_state.clickable && m_state.highlighted) || (m_state.selectable && m_state.selected)) {
+      c = m_fg.hColor;
+    }
+
+    if (m_fg.text != "") {
+      pge->DrawStringDecal(m_geometry.text, m_fg.text, c);
+    }
+
+    if (m_fgSprite != nullptr) {
+      pge->DrawPartialDecal(m_geometry.icon, m_fgSprite, olc::vi2d(), m_geometry.iconSize, m_geometry.iconScale);
+    }
+  }
+
+  void
+  Menu::layoutContent(olc::PixelGameEngine* pge) const {
+    if (m_geometry.arranged) {
+      return;
+    }
+
     // We need to display both the text and the icon
     // if needed. We assume the content will always
     // be centered along the perpendicular axis for
@@ -185,18 +287,13 @@ namespace pge {
     // Depending on whether we need to display both
     // an image or a text and in which order layout
     // in the menu will change.
-    // Also, in case there's no text nor sprite to
-    // display we can return right now.
-    if (m_fg.text == "" && m_fgSprite == nullptr) {
-      return;
-    }
-
     olc::vi2d ap = absolutePosition();
+    m_geometry.arranged = true;
 
     if (m_fg.text != "" && m_fgSprite == nullptr) {
       olc::vi2d ts = pge->GetTextSize(m_fg.text);
 
-      olc::vi2d p;
+      olc::vi2d& p = m_geometry.text;
 
       switch (m_fg.align) {
         case menu::Alignment::Center:
@@ -220,29 +317,23 @@ namespace pge {
           break;
       }
 
-      olc::Pixel c = m_fg.color;
-      if ((m_state.clickable && m_state.highlighted) || (m_state.selectable && m_state.selected)) {
-        c = m_fg.hColor;
-      }
-
-      pge->DrawStringDecal(p, m_fg.text, c);
-
       return;
     }
 
-    if (m_fg.text == "" && m_fgSprite != nullptr) {
+    if (m_fgSprite != nullptr) {
+      olc::vi2d& ss = m_geometry.iconSize;
+      ss = olc::vi2d(m_fgSprite->sprite->width, m_fgSprite->sprite->height);
+      m_geometry.iconScale = olc::vf2d(1.0f * m_fg.size.x / ss.x, 1.0f * m_fg.size.y / ss.y);
+    }
+
+    if (m_fg.text == "") {
       // Center the image if it is the only element
       // to display.
-      olc::vi2d p(
+      m_geometry.icon = olc::vi2d(
         static_cast<int>(ap.x + m_size.x / 2.0f - m_fg.size.x / 2.0f),
         static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
       );
 
-      olc::vi2d ss(m_fgSprite->sprite->width, m_fgSprite->sprite->height);
-      olc::vf2d s(1.0f * m_fg.size.x / ss.x, 1.0f * m_fg.size.y / ss.y);
-
-      pge->DrawPartialDecal(p, m_fgSprite, olc::vi2d(), ss, s);
-
       return;
     }
 
@@ -251,11 +342,8 @@ namespace pge {
     olc::vi2d ts = pge->GetTextSize(m_fg.text);
     olc::vi2d cs = ts + m_fg.size;
 
-    olc::vi2d tp;
-    olc::vi2d sp;
-
-    olc::vi2d ss(m_fgSprite->sprite->width, m_fgSprite->sprite->height);
-    olc::vf2d s(1.0f * m_fg.size.x / ss.x, 1.0f * m_fg.size.y / ss.y);
+    olc::vi2d& tp = m_geometry.text;
+    olc::vi2d& sp = m_geometry.icon;
 
     switch (m_fg.order) {
       case menu::Ordering::TextFirst:
@@ -336,16 +424,6 @@ namespace pge {
         }
         break;
     }
-
-    // Draw both the text and the image.
-    olc::Pixel c = m_fg.color;
-    if ((m_state.clickable && m_state.highlighted) || (m_state.selectable && m_state.selected)) {
-      c = m_fg.hColor;
-    }
-
-    pge->DrawStringDecal(tp, m_fg.text, c);
-
-    pge->DrawPartialDecal(sp, m_fgSprite, olc::vi2d(), ss, s);
   }
 
   void
@@ -489,6 +567,10 @@ namespace pge {
           // the icon here.
           break;
       }
+
+      // The position and the size of the child may
+      // have changed.
+      m_children[id]->invalidateLayout();
     }
   }
 
@@ -9,6 +9,7 @@
 # include "MenuContentDesc.hh"
 # include "Controls.hh"
 # include "Action.hh"
+# include "HitGrid.hh"
 
 namespace pge {
 
@@ -154,7 +155,12 @@ namespace pge {
       /**
        * @brief - Used to process the user input defined in
        *          the argument and update the internal state
-       *          of this menu if needed.
+       *          of this menu and its children if needed. The
+       *          menu under the mouse is found through a grid
+       *          built over the children the first time and
+       *          after each change of the layout: the cost of
+       *          this method does not depend on the number of
+       *          children.
        * @param c - the controls and user input for this
        *            frame.
        * @param actions - the list of actions produced by the
@@ -229,6 +235,16 @@ namespace pge {
       void
       setSimpleAction(action::Process process);
 
+      /**
+       * @brief - A counter incremented each time the appearance of
+       *          this menu or of one of its children changes. This
+       *          allows callers to only render the menu again when
+       *          it is actually needed.
+       * @return - the revision of the menu.
+       */
+      unsigned long
+      revision() const noexcept;
+
     protected:
 
       /**
@@ -270,7 +286,8 @@ namespace pge {
       /**
        * @brief - Used to obtain the absolute position of the
        *          menu within the app, considering the position
-       *          of the parent (if defined).
+       *          of the parent (if defined). The position is
+       *          cached until the layout of the menu changes.
        * @return - the absolute position of this menu.
        */
       olc::vi2d
@@ -323,8 +340,100 @@ namespace pge {
       void
       updateChildren();
 
+      /**
+       * @brief - Register that the position or the content of this
+       *          menu changed: the cached layout of this menu and
+       *          of its children will be computed again when they
+       *          are next needed.
+       */
+      void
+      invalidateLayout() noexcept;
+
+      /**
+       * @brief - Reset the cached layout of this menu and of its
+       *          children, along with their hit-test grids.
+       */
+      void
+      clearLayout() noexcept;
+
+      /**
+       * @brief - Find the visible menu displayed at the input
+       *          position among this menu and its children. The
+       *          deepest menu is returned, and the last added
+       *          one when siblings overlap.
+       * @param p - the position to look up.
+       * @return - the menu at this position or `null` if none
+       *           is found.
+       */
+      Menu*
+      pick(const olc::vi2d& p);
+
+      /**
+       * @brief - Append this menu and its children to the input
+       *          list, in the order they are rendered.
+       * @param menus - the output list of menus.
+       */
+      void
+      collect(std::vector<Menu*>& menus);
+
+      /**
+       * @brief - Compute the position of the text and of the icon
+       *          of this menu if the cached values are not up to
+       *          date anymore.
+       * @param pge - the engine used to measure the text.
+       */
+      void
+      layoutContent(olc::PixelGameEngine* pge) const;
+
+      /**
+       * @brief - Register that the appearance of this menu changed:
+       *          the revision of this menu and of its parents is
+       *          incremented.
+       */
+      void
+      invalidate() noexcept;
+
     private:
 
+      /// @brief - The layout of the menu, computed from its position,
+      /// its size and its content. It is only computed again when any
+      /// of them changes, and not at each frame.
+      struct Geometry {
+        // Whether the absolute position is up to date.
+        bool placed;
+
+        // The absolute position of the menu.
+        olc::vi2d pos;
+
+        // Whether the position of the content is up to date.
+        bool arranged;
+
+        // The absolute position of the text and of the icon.
+        olc::vi2d text;
+        olc::vi2d icon;
+
+        // The size of the sprite of the icon and the scale to
+        // apply to it to obtain the size of the icon.
+        olc::vi2d iconSize;
+        olc::vf2d iconScale;
+      };
+
+      /// @brief - The data used to process the user input for a
+      /// tree of menus.
+      struct Hits {
+        // Whether the grid reflects the current layout.
+        bool valid;
+
+        // The menus of the tree in the order they are rendered
+        // and the grid built over their areas.
+        std::vector<Menu*> menus;
+        menu::HitGrid grid;
+
+        // The menus currently highlighted and selected, if any.
+        Menu* highlighted;
+        Menu* selected;
+      };
+
       /**
        * @brief - Convenience structure describing the current state
        *          for this menu, such as visibility and highlight.
@@ -413,6 +522,25 @@ namespace pge {
        *          clicked upon.
        */
       menu::RegisterAction m_callback;
+
+      /**
+       * @brief - The revision of the appearance of this menu and of
+       *          its children.
+       */
+      unsigned long m_revision;
+
+      /**
+       * @brief - The cached layout of this menu. It is updated when
+       *          rendering the menu, hence the `mutable`.
+       */
+      mutable Geometry m_geometry;
+
+      /**
+       * @brief - The structure used to process the user input. It
+       *          is only created for the menus receiving the input
+       *          directly, usually the roots of the trees.
+       */
+      std::unique_ptr<Hits> m_hits;
   };
 
 }
@@ -20,25 +20,37 @@ namespace pge {
   inline
   void
   Menu::setVisible(bool visible) noexcept {
-    m_state.visible = visible;
+    if (m_state.visible != visible) {
+      m_state.visible = visible;
+      invalidate();
+    }
   }
 
   inline
   void
   Menu::setClickable(bool click) noexcept {
-    m_state.clickable = click;
+    if (m_state.clickable != click) {
+      m_state.clickable = click;
+      invalidate();
+    }
   }
 
   inline
   void
   Menu::setSelectable(bool select) noexcept {
-    m_state.selectable = select;
+    if (m_state.selectable != select) {
+      m_state.selectable = select;
+      invalidate();
+    }
   }
 
   inline
   void
   Menu::setEnabled(bool enabled) noexcept {
-    m_state.enabled = enabled;
+    if (m_state.enabled != enabled) {
+      m_state.enabled = enabled;
+      invalidate();
+    }
   }
 
   inline
@@ -62,7 +74,15 @@ namespace pge {
   inline
   void
   Menu::setBackground(const menu::BackgroundDesc& bg) {
+    // Menus are usually updated at each frame: only consider
+    // actual changes.
+    if (m_bg.color == bg.color && m_bg.hColor == bg.hColor && m_bg.scale == bg.scale) {
+      return;
+    }
+
     m_bg = bg;
+    invalidate();
+    invalidateLayout();
 
     // Update the parent's display if possible.
     if (m_parent != nullptr) {
@@ -76,6 +96,8 @@ namespace pge {
     clearContent();
     m_fg = mcd;
     loadFGTile();
+    invalidate();
+    invalidateLayout();
 
     // Update the parent's display if possible.
     if (m_parent != nullptr) {
@@ -86,7 +108,13 @@ namespace pge {
   inline
   void
   Menu::setText(const std::string& text) {
+    if (m_fg.text == text) {
+      return;
+    }
+
     m_fg.text = text;
+    invalidate();
+    invalidateLayout();
 
     // Update the parent's display if possible.
     if (m_parent != nullptr) {
@@ -103,6 +131,12 @@ namespace pge {
     }
   }
 
+  inline
+  unsigned long
+  Menu::revision() const noexcept {
+    return m_revision;
+  }
+
   inline
   bool
   Menu::onHighlight() const {
@@ -112,6 +146,10 @@ namespace pge {
   inline
   olc::vi2d
   Menu::absolutePosition() const noexcept {
+    if (m_geometry.placed) {
+      return m_geometry.pos;
+    }
+
     olc::vi2d p(0, 0);
 
     if (m_parent != nullptr) {
@@ -120,6 +158,9 @@ namespace pge {
 
     p += m_pos;
 
+    m_geometry.pos = p;
+    m_geometry.placed = true;
+
     return p;
   }
 
@@ -139,6 +180,44 @@ namespace pge {
   void
   Menu::clear() {}
 
+  inline
+  void
+  Menu::invalidate() noexcept {
+    ++m_revision;
+
+    if (m_parent != nullptr) {
+      m_parent->invalidate();
+    }
+  }
+
+  inline
+  void
+  Menu::invalidateLayout() noexcept {
+    clearLayout();
+
+    // The parents also need to find this menu again.
+    for (Menu* m = m_parent ; m != nullptr ; m = m->m_parent) {
+      if (m->m_hits != nullptr) {
+        m->m_hits->valid = false;
+      }
+    }
+  }
+
+  inline
+  void
+  Menu::clearLayout() noexcept {
+    m_geometry.placed = false;
+    m_geometry.arranged = false;
+
+    if (m_hits != nullptr) {
+      m_hits->valid = false;
+    }
+
+    for (unsigned id = 0u ; id < m_children.size() ; ++id) {
+      m_children[id]->clearLayout();
+    }
+  }
+
   inline
   void
   Menu::clearContent() {